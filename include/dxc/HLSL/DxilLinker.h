@@ -16,6 +16,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringMap.h"
 #include <memory>
+#include <string>
 #include "llvm/Support/ErrorOr.h"
 #include "dxc/HLSL/DxilExportMap.h"
 
@@ -49,6 +50,14 @@ public:
   virtual std::unique_ptr<llvm::Module>
   Link(llvm::StringRef entry, llvm::StringRef profile, dxilutil::ExportMap &exportMap) = 0;
 
+  // Builds a key that is equal for two Link calls that would link the same
+  // functions from the same libraries for the same entry, profile and
+  // validator version. Returns false when there is no such key, e.g. because
+  // Link would fail.
+  virtual bool GetLinkKey(llvm::StringRef entry, llvm::StringRef profile,
+                          dxilutil::ExportMap &exportMap,
+                          std::string &key) = 0;
+
 protected:
   DxilLinker(llvm::LLVMContext &Ctx, unsigned valMajor, unsigned valMinor) : m_ctx(Ctx), m_valMajor(valMajor), m_valMinor(valMinor) {}
   llvm::LLVMContext &m_ctx;
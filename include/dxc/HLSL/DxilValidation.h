@@ -331,6 +331,13 @@ HRESULT ValidateLoadModuleFromContainerLazy(
     _In_ std::unique_ptr<llvm::Module> &pDebugModule,
     _In_ llvm::LLVMContext &Ctx, llvm::LLVMContext &DbgCtx,
     _In_ llvm::raw_ostream &DiagStream);
+// Lazy loads the module to link from container: the debug module if the
+// container has one, otherwise the program module. The program part must be
+// present with a valid header either way. Validates load, but not module.
+HRESULT ValidateLoadLinkModuleFromContainerLazy(
+    _In_reads_bytes_(ContainerSize) const void *pContainer,
+    _In_ uint32_t ContainerSize, _In_ std::unique_ptr<llvm::Module> &pModule,
+    _In_ llvm::LLVMContext &Ctx, _In_ llvm::raw_ostream &DiagStream);
 
 // Load and validate Dxil module from bitcode.
 HRESULT ValidateDxilBitcode(_In_reads_bytes_(ILLength) const char *pIL,
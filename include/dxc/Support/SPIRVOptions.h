@@ -55,6 +55,10 @@ struct SpirvCodeGenOptions {
   bool useGlLayout;
   bool useScalarLayout;
   bool flattenResourceArrays;
+  /// Skip validating modules that already passed validation in this process
+  bool cacheValidation;
+  /// Print the time spent in each code generation phase to stderr
+  bool timeReport;
   SpirvLayoutRule cBufferLayoutRule;
   SpirvLayoutRule sBufferLayoutRule;
   SpirvLayoutRule tBufferLayoutRule;
@@ -365,6 +365,35 @@ public:
   DECLARE_CROSS_PLATFORM_UUIDOF(IDxcLinker)
 };
 
+struct __declspec(uuid("A00B75CE-5A78-467B-B508-98CAFB3471C5"))
+IDxcLinker2 : public IDxcLinker {
+public:
+  // Links several outputs against the same set of libraries. Libraries are
+  // attached once, and functions materialized for one output are reused by
+  // the following ones, which makes this cheaper than calling Link per output.
+  // ppResults[i] receives the result for pEntryNames[i]/pTargetProfiles[i].
+  // A non-null pExports[i] replaces any -exports given in pArguments for that
+  // output; a null element keeps the -exports from pArguments.
+  virtual HRESULT STDMETHODCALLTYPE LinkMultiple(
+    _In_count_(outputCount)
+        const LPCWSTR *pEntryNames,     // Entry point name per output (elements may be null)
+    _In_count_(outputCount)
+        const LPCWSTR *pTargetProfiles, // Shader profile per output
+    _In_opt_count_(outputCount)
+        const LPCWSTR *pExports,        // -exports value per output (optional, elements may be null)
+    _In_ UINT32 outputCount,            // Number of outputs to link
+    _In_count_(libCount)
+        const LPCWSTR *pLibNames,       // Array of library names to link
+    _In_ UINT32 libCount,               // Number of libraries to link
+    _In_opt_count_(argCount) const LPCWSTR *pArguments, // Array of pointers to arguments, shared by all outputs
+    _In_ UINT32 argCount,               // Number of arguments
+    _Out_writes_(outputCount)
+        IDxcOperationResult **ppResults // Linker output status, buffer, and errors per output
+  ) = 0;
+
+  DECLARE_CROSS_PLATFORM_UUIDOF(IDxcLinker2)
+};
+
 /////////////////////////
 // Latest interfaces. Please use these
 ////////////////////////
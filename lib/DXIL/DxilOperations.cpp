@@ -927,7 +927,9 @@ Function *OP::GetOpFunc(OpCode opCode, Type *pOverloadType) {
   OpCodeClass opClass = m_OpCodeProps[(unsigned)opCode].opCodeClass;
   Function *&F = m_OpCodeClassCache[(unsigned)opClass].pOverloads[pOverloadType];
   if (F != nullptr) {
-    UpdateCache(opClass, pOverloadType, F);
+    // Every cached overload was recorded through UpdateCache, so the reverse
+    // map is already up to date; skip rehashing on this hot path.
+    DXASSERT(m_FunctionToOpClass.count(F), "cache entry missing opcode class");
     return F;
   }
 
@@ -30,6 +30,7 @@
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/raw_ostream.h"
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -103,6 +104,9 @@ namespace {
 struct DxilFunctionLinkInfo {
   DxilFunctionLinkInfo(llvm::Function *F);
   llvm::Function *func;
+  // True once func is materialized and usedFunctions is built. Kept across
+  // links so later link jobs against the same lib reuse the work.
+  bool bLoaded;
   // SetVectors for deterministic iteration
   llvm::SetVector<llvm::Function *> usedFunctions;
   llvm::SetVector<llvm::GlobalVariable *> usedGVs;
@@ -137,6 +141,9 @@ private:
   llvm::MapVector<const llvm::Constant *, DxilResourceBase *> m_resourceMap;
   // Set of initialize functions for global variable. SetVector for deterministic iteration.
   llvm::SetVector<llvm::Function *> m_initFuncSet;
+  // Set when a function is loaded after the last BuildGlobalUsage, whose
+  // result depends on the set of materialized functions.
+  bool m_bGlobalUsageDirty;
 };
 
 struct DxilLinkJob;
@@ -154,6 +161,8 @@ public:
 
   std::unique_ptr<llvm::Module>
   Link(StringRef entry, StringRef profile, dxilutil::ExportMap &exportMap) override;
+  bool GetLinkKey(StringRef entry, StringRef profile,
+                  dxilutil::ExportMap &exportMap, std::string &key) override;
 
 private:
   bool AttachLib(DxilLib *lib);
@@ -176,7 +185,8 @@ private:
 //
 // DxilFunctionLinkInfo methods.
 //
-DxilFunctionLinkInfo::DxilFunctionLinkInfo(Function *F) : func(F) {
+DxilFunctionLinkInfo::DxilFunctionLinkInfo(Function *F)
+    : func(F), bLoaded(false) {
   DXASSERT_NOMSG(F);
 }
 
@@ -186,7 +196,8 @@ DxilFunctionLinkInfo::DxilFunctionLinkInfo(Function *F) : func(F) {
 //
 
 DxilLib::DxilLib(std::unique_ptr<llvm::Module> pModule)
-    : m_pModule(std::move(pModule)), m_DM(m_pModule->GetOrCreateDxilModule()) {
+    : m_pModule(std::move(pModule)), m_DM(m_pModule->GetOrCreateDxilModule()),
+      m_bGlobalUsageDirty(true) {
   Module &M = *m_pModule;
   const std::string &MID = M.getModuleIdentifier();
 
@@ -214,6 +225,11 @@ DxilLib::DxilLib(std::unique_ptr<llvm::Module> pModule)
 void DxilLib::LazyLoadFunction(Function *F) {
   DXASSERT(m_functionNameMap.count(F->getName()), "else invalid Function");
   DxilFunctionLinkInfo *linkInfo = m_functionNameMap[F->getName()].get();
+  if (linkInfo->bLoaded)
+    return;
+  linkInfo->bLoaded = true;
+  m_bGlobalUsageDirty = true;
+
   std::error_code EC = F->materialize();
   DXASSERT_LOCALVAR(EC, !EC, "else fail to materialize");
 
@@ -238,6 +254,10 @@ void DxilLib::LazyLoadFunction(Function *F) {
 }
 
 void DxilLib::BuildGlobalUsage() {
+  // Nothing new was materialized since the last link using this lib.
+  if (!m_bGlobalUsageDirty)
+    return;
+
   Module &M = *m_pModule;
 
   // Collect init functions for static globals.
@@ -282,6 +302,8 @@ void DxilLib::BuildGlobalUsage() {
                  m_resourceMap, m_DM);
   AddResourceMap(m_DM.GetSamplers(), DXIL::ResourceClass::Sampler,
                  m_resourceMap, m_DM);
+
+  m_bGlobalUsageDirty = false;
 }
 
 void DxilLib::CollectUsedInitFunctions(SetVector<StringRef> &addedFunctionSet,
@@ -1335,6 +1357,63 @@ DxilLinkerImpl::Link(StringRef entry, StringRef profile, dxilutil::ExportMap &ex
   }
 }
 
+bool DxilLinkerImpl::GetLinkKey(StringRef entry, StringRef profile,
+                                dxilutil::ExportMap &exportMap,
+                                std::string &key) {
+  const ShaderModel *pSM = ShaderModel::GetByName(profile.data());
+  if (!pSM->IsValid())
+    return false;
+  bool bIsLib = pSM->IsLib();
+
+  SmallVector<StringRef, 4> workList;
+  if (!bIsLib) {
+    workList.emplace_back(entry);
+  } else {
+    for (auto &it : m_functionNameMap) {
+      // IsExported is true for every function when exportMap is empty.
+      if (exportMap.IsExported(it.getKey()))
+        workList.emplace_back(it.getKey());
+    }
+  }
+
+  // Function name to the name of the lib defining it, or an empty name for
+  // functions left unresolved when linking to lib. Lib contents never change
+  // once registered, so these names identify the code Link would clone. Init
+  // functions and resources are implied by the functions and their libs.
+  std::map<StringRef, StringRef> reachable;
+  while (!workList.empty()) {
+    StringRef name = workList.pop_back_val();
+    if (reachable.count(name))
+      continue;
+    auto it = m_functionNameMap.find(name);
+    if (it == m_functionNameMap.end()) {
+      // Link reports undefined functions, except when linking to lib.
+      if (!bIsLib)
+        return false;
+      reachable[name] = StringRef();
+      continue;
+    }
+    DxilFunctionLinkInfo *linkInfo = it->second.first;
+    DxilLib *pLib = it->second.second;
+    pLib->LazyLoadFunction(linkInfo->func);
+    reachable[name] =
+        pLib->GetDxilModule().GetModule()->getModuleIdentifier();
+    for (Function *F : linkInfo->usedFunctions) {
+      if (hlsl::OP::IsDxilOpFunc(F) || F->isIntrinsic())
+        continue;
+      workList.emplace_back(F->getName());
+    }
+  }
+
+  raw_string_ostream OS(key);
+  OS << profile << ' ' << entry << ' ' << m_valMajor << '.' << m_valMinor
+     << '\n';
+  for (auto &it : reachable)
+    OS << it.second << ' ' << it.first << '\n';
+  OS.flush();
+  return true;
+}
+
 namespace hlsl {
 
 DxilLinker *DxilLinker::CreateLinker(LLVMContext &Ctx, unsigned valMajor, unsigned valMinor) {
@@ -6180,6 +6180,46 @@ _Use_decl_annotations_ HRESULT ValidateLoadModuleFromContainerLazy(
                                          pDebugModule, Ctx, DbgCtx, DiagStream,
                                          /*bLazyLoad*/ true);
 }
+// Lazy loads only the module the linker keeps, skipping the program module
+// when a debug module is present. The program part must still be present and
+// have a valid header.
+_Use_decl_annotations_ HRESULT ValidateLoadLinkModuleFromContainerLazy(
+    const void *pContainer, uint32_t ContainerSize,
+    std::unique_ptr<llvm::Module> &pModule, llvm::LLVMContext &Ctx,
+    llvm::raw_ostream &DiagStream) {
+  const DxilPartHeader *pPart = nullptr;
+  IFR(FindDxilPart(pContainer, ContainerSize, DFCC_DXIL, &pPart));
+
+  const DxilProgramHeader *pProgramHeader =
+      reinterpret_cast<const DxilProgramHeader *>(GetDxilPartData(pPart));
+  if (!IsValidDxilProgramHeader(pProgramHeader, pPart->PartSize))
+    return DXC_E_CONTAINER_INVALID;
+  const char *pIL = nullptr;
+  uint32_t ILLength = 0;
+  GetDxilProgramBitcode(pProgramHeader, &pIL, &ILLength);
+
+  HRESULT hr;
+  const DxilPartHeader *pDbgPart = nullptr;
+  if (FAILED(hr = FindDxilPart(pContainer, ContainerSize,
+                               DFCC_ShaderDebugInfoDXIL, &pDbgPart)) &&
+      hr != DXC_E_CONTAINER_MISSING_DXIL) {
+    return hr;
+  }
+
+  if (pDbgPart) {
+    // Both parts are written for the same shader model.
+    const DxilProgramHeader *pDbgHeader =
+        reinterpret_cast<const DxilProgramHeader *>(GetDxilPartData(pDbgPart));
+    if (!IsValidDxilProgramHeader(pDbgHeader, pDbgPart->PartSize))
+      return DXC_E_CONTAINER_INVALID;
+    if (pDbgHeader->ProgramVersion != pProgramHeader->ProgramVersion)
+      return DXC_E_CONTAINER_INVALID;
+    GetDxilProgramBitcode(pDbgHeader, &pIL, &ILLength);
+  }
+
+  return ValidateLoadModule(pIL, ILLength, pModule, Ctx, DiagStream,
+                            /*bLazyLoad*/ true);
+}
 
 _Use_decl_annotations_
 HRESULT ValidateDxilContainer(const void *pContainer,
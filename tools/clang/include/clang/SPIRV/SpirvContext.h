@@ -18,6 +18,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseMapInfo.h"
 #include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Allocator.h"
 
 namespace clang {
@@ -128,6 +129,34 @@ struct FunctionTypeMapInfo {
   }
 };
 
+// Provides DenseMapInfo for StructType so we can create a DenseSet of
+// struct types.
+struct StructTypeMapInfo {
+  static inline StructType *getEmptyKey() { return nullptr; }
+  static inline StructType *getTombstoneKey() { return nullptr; }
+  static unsigned getHashValue(const StructType *Val) {
+    // Hashing based on everything StructType::operator== compares.
+    auto hashCode = llvm::hash_combine(
+        Val->getStructName(), Val->isReadOnly(),
+        static_cast<uint32_t>(Val->getInterfaceType()),
+        Val->getFields().size());
+    for (const StructType::FieldInfo &field : Val->getFields())
+      hashCode = llvm::hash_combine(
+          hashCode, field.type, field.name, field.offset.hasValue(),
+          field.offset.hasValue() ? field.offset.getValue() : 0u,
+          field.matrixStride.hasValue(),
+          field.matrixStride.hasValue() ? field.matrixStride.getValue() : 0u,
+          field.isRowMajor.hasValue(),
+          field.isRowMajor.hasValue() && field.isRowMajor.getValue(),
+          field.isRelaxedPrecision, field.isPrecise);
+    return hashCode;
+  }
+  static bool isEqual(const StructType *LHS, const StructType *RHS) {
+    // Either both are null, or both should have the same underlying type.
+    return (LHS == RHS) || (LHS && RHS && *LHS == *RHS);
+  }
+};
+
 /// The class owning various SPIR-V entities allocated in memory during CodeGen.
 ///
 /// All entities should be allocated from an object of this class using
@@ -157,6 +186,18 @@ public:
   /// Deallocates the memory pointed by the given pointer.
   void deallocate(void *ptr) const {}
 
+  /// Returns a copy of the given string owned by this context. Equal strings
+  /// share the same storage.
+  ///
+  /// SPIR-V entity objects are never destructed, so any heap memory they own
+  /// (e.g., a std::string) would be leaked. Names stored on them should be
+  /// interned here instead.
+  llvm::StringRef internString(llvm::StringRef str) const {
+    if (str.empty())
+      return {};
+    return internedStrings.insert(str).first->getKey();
+  }
+
   // === DebugTypes ===
 
   // TODO: Replace uint32_t with an enum for encoding.
@@ -343,6 +384,9 @@ private:
   /// for the other fields.
   mutable llvm::BumpPtrAllocator allocator;
 
+  /// Strings interned via internString().
+  mutable llvm::StringSet<> internedStrings;
+
   // Unique types
 
   const VoidType *voidType;
@@ -371,7 +415,7 @@ private:
   llvm::DenseSet<const ArrayType *, ArrayTypeMapInfo> arrayTypes;
   llvm::DenseSet<const RuntimeArrayType *, RuntimeArrayTypeMapInfo>
       runtimeArrayTypes;
-  llvm::SmallVector<const StructType *, 8> structTypes;
+  llvm::DenseSet<const StructType *, StructTypeMapInfo> structTypes;
   llvm::DenseMap<const SpirvType *, SCToPtrTyMap> pointerTypes;
   llvm::DenseSet<FunctionType *, FunctionTypeMapInfo> functionTypes;
   const AccelerationStructureTypeNV *accelerationStructureTypeNV;
@@ -171,6 +171,9 @@ public:
 
   clang::SourceLocation getSourceLocation() const { return srcLoc; }
 
+  /// Sets the debug name of this instruction. The name is not copied; it must
+  /// outlive the instruction, e.g. by being interned via
+  /// SpirvContext::internString().
   void setDebugName(llvm::StringRef name) { debugName = name; }
   llvm::StringRef getDebugName() const { return debugName; }
 
@@ -215,10 +218,11 @@ protected:
   QualType astResultType;
   uint32_t resultId;
   SourceLocation srcLoc;
-  std::string debugName;
+  llvm::StringRef debugName;
   const SpirvType *resultType;
   uint32_t resultTypeId;
   SpirvLayoutRule layoutRule;
+  spv::StorageClass storageClass;
 
   /// Indicates whether this evaluation result contains alias variables
   ///
@@ -228,13 +232,12 @@ protected:
   /// CodeGen fall back to normal handling path.
   ///
   /// Note: legalization specific code
-  bool containsAlias;
+  bool containsAlias : 1;
 
-  spv::StorageClass storageClass;
-  bool isRValue_;
-  bool isRelaxedPrecision_;
-  bool isNonUniform_;
-  bool isPrecise_;
+  bool isRValue_ : 1;
+  bool isRelaxedPrecision_ : 1;
+  bool isNonUniform_ : 1;
+  bool isPrecise_ : 1;
 };
 
 /// \brief OpCapability instruction
@@ -711,6 +711,13 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
   if (PerFunctionPasses) {
     PrettyStackTraceString CrashInfo("Per-function optimization");
 
+    // HLSL Change Begin - Functions are visited serially on purpose.
+    // Constants, types and metadata are uniqued in the shared LLVMContext
+    // without synchronization, so running these passes for several functions
+    // at once is not safe. For HLSL this pipeline only holds
+    // SimplifyCFG/LowerExpect; lib_6_x compile time is dominated by the
+    // per-module pipeline below, which is where any partitioning must happen.
+    // HLSL Change End
     PerFunctionPasses->doInitialization();
     for (Function &F : *TheModule)
       if (!F.isDeclaration())
@@ -12,39 +12,74 @@
 namespace clang {
 namespace spirv {
 
-void BlockReadableOrderVisitor::visit(SpirvBasicBlock *block) {
-  if (doneBlocks.count(block) || todoBlocks.count(block))
+unsigned BlockReadableOrderVisitor::getBlockNumber(SpirvBasicBlock *block) {
+  auto inserted = blockNumbers.insert({block, blockNumbers.size()});
+  if (inserted.second) {
+    doneBlocks.resize(blockNumbers.size());
+    todoBlocks.resize(blockNumbers.size());
+  }
+  return inserted.first->second;
+}
+
+void BlockReadableOrderVisitor::enter(SpirvBasicBlock *block) {
+  const unsigned number = getBlockNumber(block);
+  if (doneBlocks[number] || todoBlocks[number])
     return;
 
   callback(block);
 
-  doneBlocks.insert(block);
+  doneBlocks.set(number);
 
   // Check the continue and merge targets. If any one of them exists, we need
   // to make sure visiting it is delayed until we've done the rest.
 
-  SpirvBasicBlock *continueBlock = block->getContinueTarget();
-  SpirvBasicBlock *mergeBlock = block->getMergeTarget();
+  if (SpirvBasicBlock *continueBlock = block->getContinueTarget())
+    todoBlocks.set(getBlockNumber(continueBlock));
 
-  if (continueBlock)
-    todoBlocks.insert(continueBlock);
+  if (SpirvBasicBlock *mergeBlock = block->getMergeTarget())
+    todoBlocks.set(getBlockNumber(mergeBlock));
 
-  if (mergeBlock)
-    todoBlocks.insert(mergeBlock);
-
-  for (SpirvBasicBlock *successor : block->getSuccessors())
-    visit(successor);
+  stack.push_back({block, 0, 0});
+}
 
-  // Handle continue and merge targets now.
+void BlockReadableOrderVisitor::visit(SpirvBasicBlock *block) {
+  enter(block);
 
-  if (continueBlock) {
-    todoBlocks.erase(continueBlock);
-    visit(continueBlock);
-  }
+  // Note that enter() may grow the stack, so the frame is re-read on every
+  // iteration rather than kept by reference across calls.
+  while (!stack.empty()) {
+    Frame &frame = stack.back();
+    SpirvBasicBlock *current = frame.block;
 
-  if (mergeBlock) {
-    todoBlocks.erase(mergeBlock);
-    visit(mergeBlock);
+    switch (frame.stage) {
+    case 0: {
+      llvm::ArrayRef<SpirvBasicBlock *> successors = current->getSuccessors();
+      if (frame.nextSuccessor < successors.size()) {
+        enter(successors[frame.nextSuccessor++]);
+        break;
+      }
+      // Handle continue and merge targets now.
+      frame.stage = 1;
+      break;
+    }
+    case 1:
+      frame.stage = 2;
+      if (SpirvBasicBlock *continueBlock = current->getContinueTarget()) {
+        todoBlocks.reset(getBlockNumber(continueBlock));
+        enter(continueBlock);
+      }
+      break;
+    case 2:
+      frame.stage = 3;
+      if (SpirvBasicBlock *mergeBlock = current->getMergeTarget()) {
+        todoBlocks.reset(getBlockNumber(mergeBlock));
+        enter(mergeBlock);
+      }
+      break;
+    default:
+      stack.pop_back();
+      break;
+    }
   }
 }
 
@@ -23,13 +23,21 @@
 // their branches have been visited.  This is implemented below by the
 // BlockReadableOrderVisitor.
 //
+// Generated code (e.g., long chains of if statements or huge switches) can
+// produce functions with tens of thousands of blocks, nested as deeply as the
+// chain is long. The visitor therefore keeps its own stack instead of
+// recursing, and tracks visited blocks in bit vectors indexed by a dense
+// per-traversal block number.
+//
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_CLANG_LIB_SPIRV_BLOCKREADABLEORDER_H
 #define LLVM_CLANG_LIB_SPIRV_BLOCKREADABLEORDER_H
 
 #include "clang/SPIRV/SpirvBasicBlock.h"
-#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
 
 namespace clang {
 namespace spirv {
@@ -41,16 +49,34 @@ public:
   explicit BlockReadableOrderVisitor(std::function<void(SpirvBasicBlock *)> cb)
       : callback(cb) {}
 
-  /// \brief Recursively visits all blocks reachable from the given starting
-  /// basic block in a depth-first manner and calls the callback passed-in
-  /// during construction on each basic block.
+  /// \brief Visits all blocks reachable from the given starting basic block
+  /// in a depth-first manner and calls the callback passed-in during
+  /// construction on each basic block.
   void visit(SpirvBasicBlock *block);
 
 private:
+  /// The traversal state of a block whose callback has been called but whose
+  /// successors are not all handled yet.
+  struct Frame {
+    SpirvBasicBlock *block;
+    unsigned nextSuccessor; ///< Index of the next successor to visit
+    unsigned stage;         ///< 0: successors, 1: continue, 2: merge, 3: done
+  };
+
+  /// Returns the dense number of the given block, assigning the next one if
+  /// the block has not been seen before.
+  unsigned getBlockNumber(SpirvBasicBlock *block);
+
+  /// Calls the callback on the given block and pushes its frame, unless the
+  /// block has been visited already or is delayed.
+  void enter(SpirvBasicBlock *block);
+
   std::function<void(SpirvBasicBlock *)> callback;
 
-  llvm::DenseSet<SpirvBasicBlock *> doneBlocks; ///< Blocks already visited
-  llvm::DenseSet<SpirvBasicBlock *> todoBlocks; ///< Blocks to be visited later
+  llvm::DenseMap<SpirvBasicBlock *, unsigned> blockNumbers;
+  llvm::BitVector doneBlocks; ///< Blocks already visited
+  llvm::BitVector todoBlocks; ///< Blocks to be visited later
+  llvm::SmallVector<Frame, 32> stack;
 };
 
 } // end namespace spirv
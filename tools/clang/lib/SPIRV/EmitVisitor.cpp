@@ -272,21 +272,25 @@ void EmitVisitor::finalizeInstruction(std::vector<uint32_t> *section) {
 }
 
 std::vector<uint32_t> EmitVisitor::takeBinary() {
-  std::vector<uint32_t> result;
   Header header(takeNextId(), getHeaderVersion(spvOptions.targetEnv));
   auto headerBinary = header.takeBinary();
-  result.insert(result.end(), headerBinary.begin(), headerBinary.end());
-  result.insert(result.end(), preambleBinary.begin(), preambleBinary.end());
-  result.insert(result.end(), debugFileBinary.begin(), debugFileBinary.end());
-  result.insert(result.end(), debugVariableBinary.begin(),
-                debugVariableBinary.end());
-  result.insert(result.end(), annotationsBinary.begin(),
-                annotationsBinary.end());
-  result.insert(result.end(), typeConstantBinary.begin(),
-                typeConstantBinary.end());
-  result.insert(result.end(), globalVarsBinary.begin(), globalVarsBinary.end());
-  result.insert(result.end(), richDebugInfo.begin(), richDebugInfo.end());
-  result.insert(result.end(), mainBinary.begin(), mainBinary.end());
+  std::vector<uint32_t> *sections[] = {
+      &headerBinary,        &preambleBinary,    &debugFileBinary,
+      &debugVariableBinary, &annotationsBinary, &typeConstantBinary,
+      &globalVarsBinary,    &richDebugInfo,     &mainBinary};
+
+  // Allocate the module once, and release each section as soon as it has
+  // been copied so that a large module is not held twice in full.
+  size_t numWords = 0;
+  for (const auto *section : sections)
+    numWords += section->size();
+
+  std::vector<uint32_t> result;
+  result.reserve(numWords);
+  for (auto *section : sections) {
+    result.insert(result.end(), section->begin(), section->end());
+    std::vector<uint32_t>().swap(*section);
+  }
   return result;
 }
 
@@ -1577,15 +1581,13 @@ uint32_t EmitTypeHandler::getOrCreateConstantBool(SpirvConstantBoolean *inst) {
 }
 
 uint32_t EmitTypeHandler::getOrCreateConstantNull(SpirvConstantNull *inst) {
-  auto found =
-      std::find_if(emittedConstantNulls.begin(), emittedConstantNulls.end(),
-                   [inst](SpirvConstantNull *cachedConstant) {
-                     return *cachedConstant == *inst;
-                   });
+  const auto key = std::make_pair(inst->getResultType(),
+                                 inst->getAstResultType().getAsOpaquePtr());
+  auto found = emittedConstantNulls.find(key);
 
   if (found != emittedConstantNulls.end()) {
     // We have already emitted this constant. Reuse.
-    inst->setResultId((*found)->getResultId());
+    inst->setResultId(found->second);
   } else {
     // Constant wasn't emitted in the past.
     const uint32_t typeId = emitType(inst->getResultType());
@@ -1594,7 +1596,7 @@ uint32_t EmitTypeHandler::getOrCreateConstantNull(SpirvConstantNull *inst) {
     curTypeInst.push_back(getOrAssignResultId<SpirvInstruction>(inst));
     finalizeTypeInstruction();
     // Remember this constant for the future
-    emittedConstantNulls.push_back(inst);
+    emittedConstantNulls[key] = inst->getResultId();
   }
 
   return inst->getResultId();
@@ -1775,29 +1777,20 @@ EmitTypeHandler::getOrCreateConstantComposite(SpirvConstantComposite *inst) {
   // SpecConstant instructions are not unique, so we should not re-use existing
   // spec constants.
   const bool isSpecConst = inst->isSpecConstant();
-  SpirvConstantComposite **found = nullptr;
+  std::vector<uint32_t> key;
+  auto found = emittedConstantComposites.end();
 
   if (!isSpecConst) {
-    found = std::find_if(
-        emittedConstantComposites.begin(), emittedConstantComposites.end(),
-        [inst](SpirvConstantComposite *cachedConstant) {
-          if (inst->getopcode() != cachedConstant->getopcode())
-            return false;
-          auto instConstituents = inst->getConstituents();
-          auto cachedConstituents = cachedConstant->getConstituents();
-          if (instConstituents.size() != cachedConstituents.size())
-            return false;
-          for (size_t i = 0; i < instConstituents.size(); ++i)
-            if (instConstituents[i]->getResultId() !=
-                cachedConstituents[i]->getResultId())
-              return false;
-          return true;
-        });
-  }
-
-  if (!isSpecConst && found != emittedConstantComposites.end()) {
+    key.reserve(inst->getConstituents().size() + 1);
+    key.push_back(static_cast<uint32_t>(inst->getopcode()));
+    for (auto constituent : inst->getConstituents())
+      key.push_back(constituent->getResultId());
+    found = emittedConstantComposites.find(key);
+  }
+
+  if (found != emittedConstantComposites.end()) {
     // We have already emitted this constant. Reuse.
-    inst->setResultId((*found)->getResultId());
+    inst->setResultId(found->second);
   } else {
     // Constant wasn't emitted in the past.
     const uint32_t typeId = emitType(inst->getResultType());
@@ -1810,7 +1803,7 @@ EmitTypeHandler::getOrCreateConstantComposite(SpirvConstantComposite *inst) {
 
     // Remember this constant for the future (if not a spec constant)
     if (!isSpecConst)
-      emittedConstantComposites.push_back(inst);
+      emittedConstantComposites[std::move(key)] = inst->getResultId();
   }
 
   return inst->getResultId();
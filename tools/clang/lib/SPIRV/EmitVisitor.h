@@ -14,6 +14,7 @@
 #include "llvm/ADT/StringMap.h"
 
 #include <functional>
+#include <unordered_map>
 
 namespace clang {
 namespace spirv {
@@ -54,8 +55,7 @@ public:
         debugVariableBinary(debugVec), annotationsBinary(decVec),
         typeConstantBinary(typesVec), takeNextIdFunction(takeNextIdFn),
         emittedConstantInts({}), emittedConstantFloats({}),
-        emittedConstantComposites({}), emittedConstantNulls({}),
-        emittedConstantBools() {
+        emittedConstantNulls({}), emittedConstantBools() {
     assert(decVec);
     assert(typesVec);
   }
@@ -160,8 +160,18 @@ private:
       emittedConstantInts;
   llvm::DenseMap<std::pair<uint64_t, const SpirvType *>, uint32_t>
       emittedConstantFloats;
-  llvm::SmallVector<SpirvConstantComposite *, 8> emittedConstantComposites;
-  llvm::SmallVector<SpirvConstantNull *, 8> emittedConstantNulls;
+  // Constant composites are keyed by their opcode followed by the result-ids
+  // of their constituents.
+  struct ConstantCompositeKeyHash {
+    size_t operator()(const std::vector<uint32_t> &key) const {
+      return llvm::hash_combine_range(key.begin(), key.end());
+    }
+  };
+  std::unordered_map<std::vector<uint32_t>, uint32_t, ConstantCompositeKeyHash>
+      emittedConstantComposites;
+  // Constant nulls are keyed by their SPIR-V and AST result types.
+  llvm::DenseMap<std::pair<const SpirvType *, void *>, uint32_t>
+      emittedConstantNulls;
   SpirvConstantBoolean *emittedConstantBools[2];
 
   // emittedTypes is a map that caches the result-id of types in order to avoid
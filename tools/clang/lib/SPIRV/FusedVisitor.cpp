@@ -0,0 +1,47 @@
+//===--- FusedVisitor.cpp - Fused SPIR-V Visitor -----------------*- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "FusedVisitor.h"
+
+namespace clang {
+namespace spirv {
+
+void FusedVisitor::addVisitor(Visitor *visitor) {
+  assert(visitor && "cannot add null visitor");
+  members.push_back({visitor, true});
+}
+
+bool FusedVisitor::hasActiveMembers() const {
+  for (const auto &member : members)
+    if (member.active)
+      return true;
+  return false;
+}
+
+bool FusedVisitor::visit(SpirvModule *mod, Phase phase) {
+  return forward(mod, phase);
+}
+
+bool FusedVisitor::visit(SpirvFunction *fn, Phase phase) {
+  return forward(fn, phase);
+}
+
+bool FusedVisitor::visit(SpirvBasicBlock *bb, Phase phase) {
+  return forward(bb, phase);
+}
+
+bool FusedVisitor::visitInstruction(SpirvInstruction *instr) {
+  for (auto &member : members)
+    if (member.active && !member.visitor->visitInstruction(instr))
+      member.active = false;
+  return hasActiveMembers();
+}
+
+} // end namespace spirv
+} // end namespace clang
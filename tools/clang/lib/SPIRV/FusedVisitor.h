@@ -0,0 +1,161 @@
+//===--- FusedVisitor.h - Fused SPIR-V Visitor -------------------*- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_SPIRV_FUSEDVISITOR_H
+#define LLVM_CLANG_LIB_SPIRV_FUSEDVISITOR_H
+
+#include "clang/SPIRV/SpirvVisitor.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace clang {
+namespace spirv {
+
+/// \brief A visitor that drives several other visitors in a single traversal
+/// of the module.
+///
+/// Every construct is handed to each member visitor in the order the members
+/// were added, so running a FusedVisitor gives the same result as running its
+/// members one after another, provided that no member depends on changes
+/// another member makes to constructs other than the one being visited.
+///
+/// A member that returns false stops receiving constructs, which matches what
+/// a standalone traversal does for it. The fused traversal itself only stops
+/// once no member is left.
+class FusedVisitor : public Visitor {
+public:
+  FusedVisitor(SpirvContext &spvCtx, const SpirvCodeGenOptions &opts)
+      : Visitor(opts, spvCtx) {}
+
+  /// Adds a visitor to the fused traversal. The visitor must outlive this
+  /// object.
+  void addVisitor(Visitor *visitor);
+
+  bool visit(SpirvModule *, Phase);
+  bool visit(SpirvFunction *, Phase);
+  bool visit(SpirvBasicBlock *, Phase);
+
+  // Forwards to each member's visit method of the same instruction class, so
+  // that members see exactly what a standalone traversal would show them.
+  // Keep this list in sync with the visit methods declared in SpirvVisitor.h.
+#define DEFINE_FUSED_VISIT_METHOD(cls)                                         \
+  bool visit(cls *i) { return forward(i); }
+
+  DEFINE_FUSED_VISIT_METHOD(SpirvCapability)
+  DEFINE_FUSED_VISIT_METHOD(SpirvExtension)
+  DEFINE_FUSED_VISIT_METHOD(SpirvExtInstImport)
+  DEFINE_FUSED_VISIT_METHOD(SpirvMemoryModel)
+  DEFINE_FUSED_VISIT_METHOD(SpirvEntryPoint)
+  DEFINE_FUSED_VISIT_METHOD(SpirvExecutionMode)
+  DEFINE_FUSED_VISIT_METHOD(SpirvString)
+  DEFINE_FUSED_VISIT_METHOD(SpirvSource)
+  DEFINE_FUSED_VISIT_METHOD(SpirvModuleProcessed)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDecoration)
+  DEFINE_FUSED_VISIT_METHOD(SpirvVariable)
+
+  DEFINE_FUSED_VISIT_METHOD(SpirvFunctionParameter)
+  DEFINE_FUSED_VISIT_METHOD(SpirvLoopMerge)
+  DEFINE_FUSED_VISIT_METHOD(SpirvSelectionMerge)
+  DEFINE_FUSED_VISIT_METHOD(SpirvBranching)
+  DEFINE_FUSED_VISIT_METHOD(SpirvBranch)
+  DEFINE_FUSED_VISIT_METHOD(SpirvBranchConditional)
+  DEFINE_FUSED_VISIT_METHOD(SpirvKill)
+  DEFINE_FUSED_VISIT_METHOD(SpirvReturn)
+  DEFINE_FUSED_VISIT_METHOD(SpirvSwitch)
+  DEFINE_FUSED_VISIT_METHOD(SpirvUnreachable)
+  DEFINE_FUSED_VISIT_METHOD(SpirvAccessChain)
+  DEFINE_FUSED_VISIT_METHOD(SpirvAtomic)
+  DEFINE_FUSED_VISIT_METHOD(SpirvBarrier)
+  DEFINE_FUSED_VISIT_METHOD(SpirvBinaryOp)
+  DEFINE_FUSED_VISIT_METHOD(SpirvBitFieldExtract)
+  DEFINE_FUSED_VISIT_METHOD(SpirvBitFieldInsert)
+  DEFINE_FUSED_VISIT_METHOD(SpirvConstantBoolean)
+  DEFINE_FUSED_VISIT_METHOD(SpirvConstantInteger)
+  DEFINE_FUSED_VISIT_METHOD(SpirvConstantFloat)
+  DEFINE_FUSED_VISIT_METHOD(SpirvConstantComposite)
+  DEFINE_FUSED_VISIT_METHOD(SpirvConstantNull)
+  DEFINE_FUSED_VISIT_METHOD(SpirvCompositeConstruct)
+  DEFINE_FUSED_VISIT_METHOD(SpirvCompositeExtract)
+  DEFINE_FUSED_VISIT_METHOD(SpirvCompositeInsert)
+  DEFINE_FUSED_VISIT_METHOD(SpirvEmitVertex)
+  DEFINE_FUSED_VISIT_METHOD(SpirvEndPrimitive)
+  DEFINE_FUSED_VISIT_METHOD(SpirvExtInst)
+  DEFINE_FUSED_VISIT_METHOD(SpirvFunctionCall)
+  DEFINE_FUSED_VISIT_METHOD(SpirvNonUniformBinaryOp)
+  DEFINE_FUSED_VISIT_METHOD(SpirvNonUniformElect)
+  DEFINE_FUSED_VISIT_METHOD(SpirvNonUniformUnaryOp)
+  DEFINE_FUSED_VISIT_METHOD(SpirvImageOp)
+  DEFINE_FUSED_VISIT_METHOD(SpirvImageQuery)
+  DEFINE_FUSED_VISIT_METHOD(SpirvImageSparseTexelsResident)
+  DEFINE_FUSED_VISIT_METHOD(SpirvImageTexelPointer)
+  DEFINE_FUSED_VISIT_METHOD(SpirvLoad)
+  DEFINE_FUSED_VISIT_METHOD(SpirvSampledImage)
+  DEFINE_FUSED_VISIT_METHOD(SpirvSelect)
+  DEFINE_FUSED_VISIT_METHOD(SpirvSpecConstantBinaryOp)
+  DEFINE_FUSED_VISIT_METHOD(SpirvSpecConstantUnaryOp)
+  DEFINE_FUSED_VISIT_METHOD(SpirvStore)
+  DEFINE_FUSED_VISIT_METHOD(SpirvUnaryOp)
+  DEFINE_FUSED_VISIT_METHOD(SpirvVectorShuffle)
+  DEFINE_FUSED_VISIT_METHOD(SpirvArrayLength)
+  DEFINE_FUSED_VISIT_METHOD(SpirvRayTracingOpNV)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDemoteToHelperInvocationEXT)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugInfoNone)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugSource)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugCompilationUnit)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugFunctionDeclaration)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugFunction)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugLocalVariable)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugGlobalVariable)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugOperation)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugExpression)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugDeclare)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugValue)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugLexicalBlock)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugScope)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugTypeBasic)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugTypeArray)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugTypeVector)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugTypeFunction)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugTypeComposite)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugTypeMember)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugTypeTemplate)
+  DEFINE_FUSED_VISIT_METHOD(SpirvDebugTypeTemplateParameter)
+
+#undef DEFINE_FUSED_VISIT_METHOD
+
+  bool visitInstruction(SpirvInstruction *);
+
+private:
+  template <typename T> bool forward(T *inst) {
+    for (auto &member : members)
+      if (member.active && !member.visitor->visit(inst))
+        member.active = false;
+    return hasActiveMembers();
+  }
+
+  template <typename T> bool forward(T *construct, Phase phase) {
+    for (auto &member : members)
+      if (member.active && !member.visitor->visit(construct, phase))
+        member.active = false;
+    return hasActiveMembers();
+  }
+
+  bool hasActiveMembers() const;
+
+private:
+  struct Member {
+    Visitor *visitor;
+    bool active;
+  };
+  llvm::SmallVector<Member, 4> members;
+};
+
+} // end namespace spirv
+} // end namespace clang
+
+#endif // LLVM_CLANG_LIB_SPIRV_FUSEDVISITOR_H
@@ -974,9 +974,9 @@ LowerTypeVisitor::generateFunctionInfo(const CXXMethodDecl *decl,
   // using FlagIsPublic for now.
   uint32_t flags = 3u;
   auto scopeLine = sm.getPresumedLineNumber(decl->getBody()->getLocStart());
-  SpirvDebugFunction *fn = new (spvContext)
-      SpirvDebugFunction(funcName, debugInfo->source, line, column, parent,
-                         funcName, flags, scopeLine, nullptr);
+  SpirvDebugFunction *fn = new (spvContext) SpirvDebugFunction(
+      spvContext.internString(funcName), debugInfo->source, line, column,
+      parent, funcName, flags, scopeLine, nullptr);
   fn->setFunctionType(fnType);
   return fn;
 }
@@ -11,12 +11,14 @@
 #include "CapabilityVisitor.h"
 #include "DebugTypeVisitor.h"
 #include "EmitVisitor.h"
+#include "FusedVisitor.h"
 #include "LiteralTypeVisitor.h"
 #include "LowerTypeVisitor.h"
 #include "PreciseVisitor.h"
 #include "RelaxedPrecisionVisitor.h"
 #include "RemoveBufferBlockVisitor.h"
 #include "clang/SPIRV/AstTypeProbe.h"
+#include "llvm/Support/Timer.h"
 
 namespace clang {
 namespace spirv {
@@ -57,7 +59,7 @@ SpirvFunctionParameter *SpirvBuilder::addFnParam(QualType ptrType,
   assert(function && "found detached parameter");
   auto *param = new (context) SpirvFunctionParameter(ptrType, isPrecise, loc);
   param->setStorageClass(spv::StorageClass::Function);
-  param->setDebugName(name);
+  param->setDebugName(context.internString(name));
   function->addParameter(param);
   return param;
 }
@@ -68,7 +70,7 @@ SpirvVariable *SpirvBuilder::addFnVar(QualType valueType, SourceLocation loc,
   assert(function && "found detached local variable");
   auto *var = new (context) SpirvVariable(
       valueType, loc, spv::StorageClass::Function, isPrecise, init);
-  var->setDebugName(name);
+  var->setDebugName(context.internString(name));
   function->addVariable(var);
   return var;
 }
@@ -821,7 +823,8 @@ SpirvDebugLocalVariable *SpirvBuilder::createDebugLocalVariable(
     uint32_t line, uint32_t column, SpirvDebugInstruction *parentScope,
     uint32_t flags, llvm::Optional<uint32_t> argNumber) {
   auto *inst = new (context) SpirvDebugLocalVariable(
-      debugQualType, varName, src, line, column, parentScope, flags, argNumber);
+      debugQualType, context.internString(varName), src, line, column,
+      parentScope, flags, argNumber);
   mod->addDebugInfo(inst);
   return inst;
 }
@@ -832,8 +835,8 @@ SpirvDebugGlobalVariable *SpirvBuilder::createDebugGlobalVariable(
     llvm::StringRef linkageName, SpirvVariable *var, uint32_t flags,
     llvm::Optional<SpirvInstruction *> staticMemberDebugType) {
   auto *inst = new (context) SpirvDebugGlobalVariable(
-      debugType, varName, src, line, column, parentScope, linkageName, var,
-      flags, staticMemberDebugType);
+      debugType, context.internString(varName), src, line, column, parentScope,
+      linkageName, var, flags, staticMemberDebugType);
   mod->addDebugInfo(inst);
   return inst;
 }
@@ -891,7 +894,8 @@ SpirvDebugFunction *SpirvBuilder::createDebugFunction(
     SpirvDebugInstruction *parentScope, llvm::StringRef linkageName,
     uint32_t flags, uint32_t scopeLine, SpirvFunction *fn) {
   auto *inst = new (context) SpirvDebugFunction(
-      name, src, line, column, parentScope, linkageName, flags, scopeLine, fn);
+      context.internString(name), src, line, column, parentScope, linkageName,
+      flags, scopeLine, fn);
   mod->addDebugInfo(inst);
   return inst;
 }
@@ -925,7 +929,7 @@ SpirvVariable *SpirvBuilder::addStageIOVar(QualType type,
                                            SourceLocation loc) {
   // Note: We store the underlying type in the variable, *not* the pointer type.
   auto *var = new (context) SpirvVariable(type, loc, storageClass, isPrecise);
-  var->setDebugName(name);
+  var->setDebugName(context.internString(name));
   mod->addVariable(var);
   return var;
 }
@@ -971,7 +975,7 @@ SpirvBuilder::addModuleVar(QualType type, spv::StorageClass storageClass,
   auto *var =
       new (context) SpirvVariable(type, loc, storageClass, isPrecise,
                                   init.hasValue() ? init.getValue() : nullptr);
-  var->setDebugName(name);
+  var->setDebugName(context.internString(name));
   mod->addVariable(var);
   return var;
 }
@@ -986,7 +990,7 @@ SpirvVariable *SpirvBuilder::addModuleVar(
       new (context) SpirvVariable(/*QualType*/ {}, loc, storageClass, isPrecise,
                                   init.hasValue() ? init.getValue() : nullptr);
   var->setResultType(type);
-  var->setDebugName(name);
+  var->setDebugName(context.internString(name));
   mod->addVariable(var);
   return var;
 }
@@ -1175,30 +1179,66 @@ std::vector<uint32_t> SpirvBuilder::takeModule() {
   RemoveBufferBlockVisitor removeBufferBlockVisitor(context, spirvOptions);
   EmitVisitor emitVisitor(astContext, context, spirvOptions);
 
-  mod->invokeVisitor(&literalTypeVisitor, true);
+  // Adding capabilities, propagating RelaxedPrecision and removing the
+  // BufferBlock decoration each only look at the construct being visited and
+  // never at what the others change elsewhere, so they share one traversal.
+  FusedVisitor fusedVisitor(context, spirvOptions);
+  fusedVisitor.addVisitor(&capabilityVisitor);
+  fusedVisitor.addVisitor(&relaxedPrecisionVisitor);
+  fusedVisitor.addVisitor(&removeBufferBlockVisitor);
+
+  // Time each traversal for -fspv-time-report.
+  llvm::TimerGroup timerGroup("SPIR-V Visitors");
+  llvm::Timer literalTypeTimer, lowerTypeTimer, debugTypeTimer, fusedTimer,
+      preciseTimer, emitTimer;
+  if (spirvOptions.timeReport) {
+    literalTypeTimer.init("Literal types", timerGroup);
+    lowerTypeTimer.init("Lower types", timerGroup);
+    debugTypeTimer.init("Debug types", timerGroup);
+    fusedTimer.init("Capabilities, RelaxedPrecision, BufferBlock", timerGroup);
+    preciseTimer.init("NoContraction", timerGroup);
+    emitTimer.init("Emit", timerGroup);
+  }
+  auto getTimer = [](llvm::Timer &timer) {
+    return timer.isInitialized() ? &timer : nullptr;
+  };
+
+  {
+    llvm::TimeRegion region(getTimer(literalTypeTimer));
+    mod->invokeVisitor(&literalTypeVisitor, true);
+  }
 
   // Lower types
-  mod->invokeVisitor(&lowerTypeVisitor);
+  {
+    llvm::TimeRegion region(getTimer(lowerTypeTimer));
+    mod->invokeVisitor(&lowerTypeVisitor);
+  }
 
   // Generate debug types (if needed)
-  if (spirvOptions.debugInfoRich)
+  if (spirvOptions.debugInfoRich) {
+    llvm::TimeRegion region(getTimer(debugTypeTimer));
     mod->invokeVisitor(&debugTypeVisitor);
+  }
 
-  // Add necessary capabilities and extensions
-  mod->invokeVisitor(&capabilityVisitor);
-
-  // Propagate RelaxedPrecision decorations
-  mod->invokeVisitor(&relaxedPrecisionVisitor);
+  // Add necessary capabilities and extensions, propagate RelaxedPrecision
+  // decorations, and remove BufferBlock decoration if necessary (this
+  // decoration is deprecated after SPIR-V 1.3).
+  {
+    llvm::TimeRegion region(getTimer(fusedTimer));
+    mod->invokeVisitor(&fusedVisitor);
+  }
 
   // Propagate NoContraction decorations
-  mod->invokeVisitor(&preciseVisitor, true);
-
-  // Remove BufferBlock decoration if necessary (this decoration is deprecated
-  // after SPIR-V 1.3).
-  mod->invokeVisitor(&removeBufferBlockVisitor);
+  {
+    llvm::TimeRegion region(getTimer(preciseTimer));
+    mod->invokeVisitor(&preciseVisitor, true);
+  }
 
   // Emit SPIR-V
-  mod->invokeVisitor(&emitVisitor);
+  {
+    llvm::TimeRegion region(getTimer(emitTimer));
+    mod->invokeVisitor(&emitVisitor);
+  }
 
   return emitVisitor.takeBinary();
 }
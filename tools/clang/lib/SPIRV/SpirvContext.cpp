@@ -190,17 +190,14 @@ SpirvContext::getStructType(llvm::ArrayRef<StructType::FieldInfo> fields,
 
   StructType type(fields, name, isReadOnly, interfaceType);
 
-  auto found = std::find_if(
-      structTypes.begin(), structTypes.end(),
-      [&type](const StructType *cachedType) { return type == *cachedType; });
-
+  auto found = structTypes.find(&type);
   if (found != structTypes.end())
     return *found;
 
-  structTypes.push_back(
-      new (this) StructType(fields, name, isReadOnly, interfaceType));
-
-  return structTypes.back();
+  const auto *ptr =
+      new (this) StructType(fields, name, isReadOnly, interfaceType);
+  structTypes.insert(ptr);
+  return ptr;
 }
 
 const HybridStructType *SpirvContext::getHybridStructType(
@@ -275,7 +272,8 @@ SpirvContext::getDebugTypeBasic(const SpirvType *spirvType,
   if (debugTypes.find(spirvType) != debugTypes.end())
     return debugTypes[spirvType];
 
-  auto *debugType = new (this) SpirvDebugTypeBasic(name, size, encoding);
+  auto *debugType =
+      new (this) SpirvDebugTypeBasic(internString(name), size, encoding);
   debugTypes[spirvType] = debugType;
   return debugType;
 }
@@ -288,7 +286,8 @@ SpirvDebugInstruction *SpirvContext::getDebugTypeMember(
   // spirvType but has different parent i.e., type composite.
 
   SpirvDebugTypeMember *debugType = new (this) SpirvDebugTypeMember(
-      name, type, source, line, column, parent, flags, offset, value);
+      internString(name), type, source, line, column, parent, flags, offset,
+      value);
 
   // NOTE: Do not save it in debugTypes because it would have the same
   // spirvType but it has different parent i.e., type composite. Instead,
@@ -306,7 +305,8 @@ SpirvDebugInstruction *SpirvContext::getDebugTypeComposite(
     return debugTypes[spirvType];
 
   auto *debugType = new (this) SpirvDebugTypeComposite(
-      name, source, line, column, parent, linkageName, size, flags, tag);
+      internString(name), source, line, column, parent, linkageName, size,
+      flags, tag);
   debugType->setDebugSpirvType(spirvType);
   debugTypes[spirvType] = debugType;
   return debugType;
@@ -421,8 +421,8 @@ SpirvDebugInstruction *SpirvContext::getDebugTypeTemplateParameter(
     }
   }
 
-  auto *debugType = new (this)
-      SpirvDebugTypeTemplateParameter(name, type, value, source, line, column);
+  auto *debugType = new (this) SpirvDebugTypeTemplateParameter(
+      internString(name), type, value, source, line, column);
   if (tempType)
     tempType->getParams().push_back(debugType);
   return debugType;
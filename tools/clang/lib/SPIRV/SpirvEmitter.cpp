@@ -19,7 +19,12 @@
 #include "spirv-tools/optimizer.hpp"
 #include "clang/SPIRV/AstTypeProbe.h"
 #include "clang/Sema/Sema.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/Timer.h"
+#include <set>
 
 #include "InitListHandler.h"
 
@@ -194,9 +199,58 @@ bool spirvToolsOptimize(spv_target_env env, std::vector<uint32_t> *mod,
   return optimizer.Run(mod->data(), mod->size(), mod, options);
 }
 
+/// \brief The modules that passed validation in this process, for
+/// -fspv-validation-cache.
+///
+/// A module is identified by a hash of its words and of the validation
+/// options, together with its size. Only successful validations are recorded,
+/// so an invalid module always gets its messages reported.
+class SpirvValidationCache {
+public:
+  typedef std::pair<size_t, size_t> Key;
+
+  static Key getKey(spv_target_env env, const SpirvCodeGenOptions &opts,
+                    bool beforeHlslLegalization,
+                    const std::vector<uint32_t> &mod) {
+    const size_t hash = llvm::hash_combine(
+        llvm::hash_combine_range(mod.begin(), mod.end()),
+        static_cast<int>(env), beforeHlslLegalization, opts.useScalarLayout,
+        opts.useDxLayout, opts.useGlLayout);
+    return Key(hash, mod.size());
+  }
+
+  bool contains(const Key &key) {
+    llvm::sys::ScopedLock lock(mutex);
+    return validated.count(key) != 0;
+  }
+
+  void insert(const Key &key) {
+    llvm::sys::ScopedLock lock(mutex);
+    if (validated.size() >= kMaxEntries)
+      validated.clear();
+    validated.insert(key);
+  }
+
+private:
+  static const size_t kMaxEntries = 1 << 16;
+
+  llvm::sys::Mutex mutex;
+  std::set<Key> validated;
+};
+
+llvm::ManagedStatic<SpirvValidationCache> g_SpirvValidationCache;
+
 bool spirvToolsValidate(spv_target_env env, const SpirvCodeGenOptions &opts,
                         bool beforeHlslLegalization, std::vector<uint32_t> *mod,
                         std::string *messages) {
+  SpirvValidationCache::Key cacheKey;
+  if (opts.cacheValidation) {
+    cacheKey = SpirvValidationCache::getKey(env, opts, beforeHlslLegalization,
+                                            *mod);
+    if (g_SpirvValidationCache->contains(cacheKey))
+      return true;
+  }
+
   spvtools::SpirvTools tools(env);
 
   tools.SetMessageConsumer(
@@ -217,7 +271,12 @@ bool spirvToolsValidate(spv_target_env env, const SpirvCodeGenOptions &opts,
     options.SetRelaxBlockLayout(true);
   }
 
-  return tools.Validate(mod->data(), mod->size(), options);
+  if (!tools.Validate(mod->data(), mod->size(), options))
+    return false;
+
+  if (opts.cacheValidation)
+    g_SpirvValidationCache->insert(cacheKey);
+  return true;
 }
 
 /// Translates atomic HLSL opcodes into the equivalent SPIR-V opcode.
@@ -589,6 +648,17 @@ void SpirvEmitter::HandleTranslationUnit(ASTContext &context) {
   if (context.getDiagnostics().hasErrorOccurred())
     return;
 
+  // Time each phase of SPIR-V code generation for -fspv-time-report. The
+  // report is printed to stderr when the timers go out of scope.
+  llvm::TimerGroup timerGroup("SPIR-V CodeGen");
+  llvm::Timer translationTimer, optimizerTimer, validatorTimer;
+  if (spirvOptions.timeReport) {
+    translationTimer.init("AST translation", timerGroup);
+    optimizerTimer.init("Legalization and optimization", timerGroup);
+    validatorTimer.init("Validation", timerGroup);
+    translationTimer.startTimer();
+  }
+
   TranslationUnitDecl *tu = context.getTranslationUnitDecl();
   uint32_t numEntryPoints = 0;
 
@@ -660,10 +730,16 @@ void SpirvEmitter::HandleTranslationUnit(ASTContext &context) {
   if (!declIdMapper.decorateResourceBindings())
     return;
 
+  if (translationTimer.isInitialized())
+    translationTimer.stopTimer();
+
   // Output the constructed module.
   std::vector<uint32_t> m = spvBuilder.takeModule();
 
   if (!spirvOptions.codeGenHighLevel) {
+    llvm::TimeRegion region(optimizerTimer.isInitialized() ? &optimizerTimer
+                                                           : nullptr);
+
     // In order to flatten resource arrays, we must also unroll loops. Therefore
     // we should run legalization before optimization.
     needsLegalization = needsLegalization || spirvOptions.flattenResourceArrays;
@@ -699,6 +775,8 @@ void SpirvEmitter::HandleTranslationUnit(ASTContext &context) {
 
   // Validate the generated SPIR-V code
   if (!spirvOptions.disableValidation) {
+    llvm::TimeRegion region(validatorTimer.isInitialized() ? &validatorTimer
+                                                           : nullptr);
     std::string messages;
     if (!spirvToolsValidate(targetEnv, spirvOptions,
                             needsLegalization ||
@@ -6457,7 +6535,7 @@ void SpirvEmitter::createSpecConstant(const VarDecl *varDecl) {
       specConstant, varDecl->getAttr<VKConstantIdAttr>()->getSpecConstId(),
       varDecl->getLocation());
 
-  specConstant->setDebugName(varDecl->getName());
+  specConstant->setDebugName(spvContext.internString(varDecl->getName()));
   declIdMapper.registerSpecConstant(varDecl, specConstant);
 }
 
@@ -110,9 +110,10 @@ SpirvInstruction::SpirvInstruction(Kind k, spv::Op op, QualType astType,
                                    SourceLocation loc)
     : kind(k), opcode(op), astResultType(astType), resultId(0), srcLoc(loc),
       debugName(), resultType(nullptr), resultTypeId(0),
-      layoutRule(SpirvLayoutRule::Void), containsAlias(false),
-      storageClass(spv::StorageClass::Function), isRValue_(false),
-      isRelaxedPrecision_(false), isNonUniform_(false), isPrecise_(false) {}
+      layoutRule(SpirvLayoutRule::Void),
+      storageClass(spv::StorageClass::Function), containsAlias(false),
+      isRValue_(false), isRelaxedPrecision_(false), isNonUniform_(false),
+      isPrecise_(false) {}
 
 bool SpirvInstruction::isArithmeticInstruction() const {
   switch (opcode) {
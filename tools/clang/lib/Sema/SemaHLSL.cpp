@@ -12,6 +12,7 @@
 
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Attr.h"
 #include "clang/AST/DeclCXX.h"
@@ -38,8 +39,10 @@
 #include "gen_intrin_main_tables_15.h"
 #include "dxc/HLSL/HLOperations.h"
 #include "dxc/DXIL/DxilShaderModel.h"
+#include <algorithm>
 #include <array>
 #include <float.h>
+#include <map>
 
 enum ArBasicKind {
   AR_BASIC_BOOL,
@@ -2879,15 +2882,62 @@ private:
   TypedefDecl* m_hlslStringTypedef;
 
   // Built-in object types declarations, indexed by basic kind constant.
+  // Created on first use by GetObjectTypeDecl.
   CXXRecordDecl* m_objectTypeDecls[_countof(g_ArBasicKindsAsTypes)];
   // Map from object decl to the object index.
-  using ObjectTypeDeclMapType = std::array<std::pair<CXXRecordDecl*,unsigned>, _countof(g_ArBasicKindsAsTypes)+_countof(g_DeprecatedEffectObjectNames)>;
-  ObjectTypeDeclMapType m_objectTypeDeclsMap;
+  llvm::DenseMap<const CXXRecordDecl*, unsigned> m_objectTypeDeclsMap;
   // Mask for object which not has methods created.
   uint64_t m_objectTypeLazyInitMask;
+  // Set while GetObjectTypeDecl declares a type, so that adding the new
+  // declaration to the translation unit doesn't look its name up again.
+  bool m_declaringObjectType;
 
   UsedIntrinsicStore m_usedIntrinsics;
 
+  // For each intrinsic name in a table, the argument counts it is declared
+  // with (including the return) and the index of the first such entry.
+  typedef llvm::StringMap<llvm::SmallVector<std::pair<unsigned, unsigned>, 2>>
+      IntrinsicTableIndex;
+  // Intrinsic name followed by the canonical argument types of a call.
+  typedef std::vector<const void *> IntrinsicCallKey;
+  // Overload each intrinsic call resolved to, by IntrinsicCallKey.
+  std::map<IntrinsicCallKey, FunctionDecl *> m_intrinsicCallMemo;
+
+  // Indices of intrinsic tables, built the first time a table is searched.
+  llvm::DenseMap<const HLSL_INTRINSIC *, std::unique_ptr<IntrinsicTableIndex>>
+      m_intrinsicTableIndices;
+
+  // Type information for a structural type (see GetStructuralForm).
+  struct TypeInfoRecord {
+    ArTypeInfo Info;
+    // IsTypeNumeric results for arrays and structs, once computed.
+    bool NumericKnown : 1;
+    bool Numeric : 1;
+    UINT NumericCount;
+  };
+  // Records by structural type, created on first use by GetTypeInfoRecord.
+  llvm::DenseMap<const clang::Type *, TypeInfoRecord> m_typeInfoRecords;
+  TypeInfoRecord &GetTypeInfoRecord(QualType type);
+  bool IsAggregateTypeNumeric(QualType type, _Out_ UINT *count);
+
+  const IntrinsicTableIndex &GetIntrinsicTableIndex(
+      _In_count_(tableSize) const HLSL_INTRINSIC *table, size_t tableSize) {
+    std::unique_ptr<IntrinsicTableIndex> &index = m_intrinsicTableIndices[table];
+    if (!index) {
+      index.reset(new IntrinsicTableIndex());
+      for (unsigned i = 0; i < tableSize; i++) {
+        auto &entries = (*index)[table[i].pArgs[0].pName];
+        auto found = std::find_if(entries.begin(), entries.end(),
+            [&](const std::pair<unsigned, unsigned> &entry) {
+              return entry.first == table[i].uNumArgs;
+            });
+        if (found == entries.end())
+          entries.emplace_back(table[i].uNumArgs, i);
+      }
+    }
+    return *index;
+  }
+
   /// <summary>Add all base QualTypes for each hlsl scalar types.</summary>
   void AddBaseTypes();
 
@@ -3252,107 +3302,146 @@ private:
     }
   }
 
-  static bool ObjectTypeDeclMapTypeCmp(const std::pair<CXXRecordDecl*,unsigned> &a,
-                           const std::pair<CXXRecordDecl*,unsigned> &b) {
-    return a.first < b.first;
-  };
-
   int FindObjectBasicKindIndex(const CXXRecordDecl* recordDecl) {
-    auto begin = m_objectTypeDeclsMap.begin();
-    auto end = m_objectTypeDeclsMap.end();
-    auto val = std::make_pair(const_cast<CXXRecordDecl*>(recordDecl), 0);
-    auto low = std::lower_bound(begin, end, val, ObjectTypeDeclMapTypeCmp);
-    if (low == end)
+    auto it = m_objectTypeDeclsMap.find(recordDecl);
+    if (it == m_objectTypeDeclsMap.end())
       return -1;
-    if (recordDecl == low->first)
-      return low->second;
+    return it->second;
+  }
+
+  // Returns whether the object type at index i of g_ArBasicKindsAsTypes can
+  // be named in source. Wave objects are unused, and some internal types
+  // (e.g. '.Resource') are declared under a name that differs from their
+  // g_ArBasicTypeNames entry.
+  static bool IsNamedObjectType(unsigned i) {
+    ArBasicKind kind = g_ArBasicKindsAsTypes[i];
+    return kind != AR_OBJECT_WAVE && kind != AR_OBJECT_RESOURCE;
+  }
+
+  // Returns the index in g_ArBasicKindsAsTypes of the built-in object type
+  // with the given name, or -1.
+  static int FindObjectBasicKindIndexByName(StringRef name) {
+    for (unsigned i = 0; i < _countof(g_ArBasicKindsAsTypes); i++) {
+      if (IsNamedObjectType(i) &&
+          name.equals(g_ArBasicTypeNames[g_ArBasicKindsAsTypes[i]]))
+        return i;
+    }
+    return -1;
+  }
+
+  // Returns the built-in object type at index i of g_ArBasicKindsAsTypes,
+  // declaring it first if needed. Object types are declared on demand, when
+  // name lookup or Sema first needs them, because a shader typically uses a
+  // handful of the dozens of types.
+  CXXRecordDecl *GetObjectTypeDecl(unsigned i)
+  {
+    DXASSERT(m_context != nullptr, "otherwise caller hasn't initialized context yet");
+    DXASSERT_NOMSG(i < _countof(g_ArBasicKindsAsTypes));
+    if (m_objectTypeDecls[i] != nullptr)
+      return m_objectTypeDecls[i];
+
+    ArBasicKind kind = g_ArBasicKindsAsTypes[i];
+    if (kind == AR_OBJECT_WAVE) { // wave objects are currently unused
+      return nullptr;
+    }
+
+    DXASSERT(kind < _countof(g_ArBasicTypeNames), "g_ArBasicTypeNames has the wrong number of entries");
+    _Analysis_assume_(kind < _countof(g_ArBasicTypeNames));
+    const char* typeName = g_ArBasicTypeNames[kind];
+    uint8_t templateArgCount = g_ArBasicKindsTemplateCount[i];
+    CXXRecordDecl* recordDecl = nullptr;
+    DXASSERT(!m_declaringObjectType, "object type declarations don't nest");
+    m_declaringObjectType = true;
+    if (kind == AR_OBJECT_RAY_DESC) {
+      QualType float3Ty = LookupVectorType(HLSLScalarType::HLSLScalarType_float, 3);
+      recordDecl = CreateRayDescStruct(*m_context, float3Ty);
+    } else if (kind == AR_OBJECT_TRIANGLE_INTERSECTION_ATTRIBUTES) {
+      QualType float2Type = LookupVectorType(HLSLScalarType::HLSLScalarType_float, 2);
+      recordDecl = AddBuiltInTriangleIntersectionAttributes(*m_context, float2Type);
+    } else if (IsSubobjectBasicKind(kind)) {
+      switch (kind) {
+      case AR_OBJECT_STATE_OBJECT_CONFIG:
+        recordDecl = CreateSubobjectStateObjectConfig(*m_context);
+        break;
+      case AR_OBJECT_GLOBAL_ROOT_SIGNATURE:
+        recordDecl = CreateSubobjectRootSignature(*m_context, true);
+        break;
+      case AR_OBJECT_LOCAL_ROOT_SIGNATURE:
+        recordDecl = CreateSubobjectRootSignature(*m_context, false);
+        break;
+      case AR_OBJECT_SUBOBJECT_TO_EXPORTS_ASSOC:
+        recordDecl = CreateSubobjectSubobjectToExportsAssoc(*m_context);
+        break;
+      case AR_OBJECT_RAYTRACING_SHADER_CONFIG:
+        recordDecl = CreateSubobjectRaytracingShaderConfig(*m_context);
+        break;
+      case AR_OBJECT_RAYTRACING_PIPELINE_CONFIG:
+        recordDecl = CreateSubobjectRaytracingPipelineConfig(*m_context);
+        break;
+      case AR_OBJECT_TRIANGLE_HIT_GROUP:
+        recordDecl = CreateSubobjectTriangleHitGroup(*m_context);
+        break;
+      case AR_OBJECT_PROCEDURAL_PRIMITIVE_HIT_GROUP:
+        recordDecl = CreateSubobjectProceduralPrimitiveHitGroup(*m_context);
+        break;
+      case AR_OBJECT_RAYTRACING_PIPELINE_CONFIG1:
+        recordDecl = CreateSubobjectRaytracingPipelineConfig1(*m_context);
+        break;
+      }
+    } else if (kind == AR_OBJECT_RAY_QUERY) {
+      recordDecl = DeclareRayQueryType(*m_context);
+    } else if (kind == AR_OBJECT_RESOURCE) {
+      recordDecl = DeclareResourceType(*m_context);
+    }
+    else if (kind == AR_OBJECT_FEEDBACKTEXTURE2D) {
+      recordDecl = DeclareUIntTemplatedTypeWithHandle(*m_context, "FeedbackTexture2D", "kind");
+    }
+    else if (kind == AR_OBJECT_FEEDBACKTEXTURE2D_ARRAY) {
+      recordDecl = DeclareUIntTemplatedTypeWithHandle(*m_context, "FeedbackTexture2DArray", "kind");
+    }
+    else if (templateArgCount == 0) {
+      recordDecl = DeclareRecordTypeWithHandle(*m_context, typeName);
+    }
     else
-      return -1;
+    {
+      DXASSERT(templateArgCount == 1 || templateArgCount == 2, "otherwise a new case has been added");
+
+      TypeSourceInfo* typeDefault = nullptr;
+      if (TemplateHasDefaultType(kind)) {
+        QualType float4Type = LookupVectorType(HLSLScalarType_float, 4);
+        typeDefault = m_context->getTrivialTypeSourceInfo(float4Type, NoLoc);
+      }
+      recordDecl = DeclareTemplateTypeWithHandle(*m_context, typeName, templateArgCount, typeDefault);
+    }
+    m_declaringObjectType = false;
+    m_objectTypeDecls[i] = recordDecl;
+    m_objectTypeDeclsMap[recordDecl] = i;
+    m_objectTypeLazyInitMask |= ((uint64_t)1)<<i;
+
+    // Extension intrinsic tables registered so far add methods to the type.
+    for (auto && intrinsic : m_intrinsicTables) {
+      AddIntrinsicTableMethods(intrinsic, i);
+    }
+    return recordDecl;
   }
 
-  // Adds all built-in HLSL object types.
+  // Adds the built-in HLSL object type declarations needed up front. Other
+  // object types are declared by GetObjectTypeDecl when first used.
   void AddObjectTypes()
   {
     DXASSERT(m_context != nullptr, "otherwise caller hasn't initialized context yet");
 
-    QualType float4Type = LookupVectorType(HLSLScalarType_float, 4);
-    TypeSourceInfo *float4TypeSourceInfo = m_context->getTrivialTypeSourceInfo(float4Type, NoLoc);
+    // Any lookup into the translation unit, qualified or not, consults
+    // FindExternalVisibleDeclsByName for names it hasn't seen yet, which
+    // declares the matching object type.
+    m_context->getTranslationUnitDecl()->setHasExternalVisibleStorage(true);
+
     m_objectTypeLazyInitMask = 0;
     unsigned effectKindIndex = 0;
     for (unsigned i = 0; i < _countof(g_ArBasicKindsAsTypes); i++)
     {
-      ArBasicKind kind = g_ArBasicKindsAsTypes[i];
-      if (kind == AR_OBJECT_WAVE) { // wave objects are currently unused
-        continue;
-      }
-      if (kind == AR_OBJECT_LEGACY_EFFECT)
+      if (g_ArBasicKindsAsTypes[i] == AR_OBJECT_LEGACY_EFFECT)
         effectKindIndex = i;
-
-      DXASSERT(kind < _countof(g_ArBasicTypeNames), "g_ArBasicTypeNames has the wrong number of entries");
-      _Analysis_assume_(kind < _countof(g_ArBasicTypeNames));
-      const char* typeName = g_ArBasicTypeNames[kind];
-      uint8_t templateArgCount = g_ArBasicKindsTemplateCount[i];
-      CXXRecordDecl* recordDecl = nullptr;
-      if (kind == AR_OBJECT_RAY_DESC) {
-        QualType float3Ty = LookupVectorType(HLSLScalarType::HLSLScalarType_float, 3);
-        recordDecl = CreateRayDescStruct(*m_context, float3Ty);
-      } else if (kind == AR_OBJECT_TRIANGLE_INTERSECTION_ATTRIBUTES) {
-        QualType float2Type = LookupVectorType(HLSLScalarType::HLSLScalarType_float, 2);
-        recordDecl = AddBuiltInTriangleIntersectionAttributes(*m_context, float2Type);
-      } else if (IsSubobjectBasicKind(kind)) {
-        switch (kind) {
-        case AR_OBJECT_STATE_OBJECT_CONFIG:
-          recordDecl = CreateSubobjectStateObjectConfig(*m_context);
-          break;
-        case AR_OBJECT_GLOBAL_ROOT_SIGNATURE:
-          recordDecl = CreateSubobjectRootSignature(*m_context, true);
-          break;
-        case AR_OBJECT_LOCAL_ROOT_SIGNATURE:
-          recordDecl = CreateSubobjectRootSignature(*m_context, false);
-          break;
-        case AR_OBJECT_SUBOBJECT_TO_EXPORTS_ASSOC:
-          recordDecl = CreateSubobjectSubobjectToExportsAssoc(*m_context);
-          break;
-        case AR_OBJECT_RAYTRACING_SHADER_CONFIG:
-          recordDecl = CreateSubobjectRaytracingShaderConfig(*m_context);
-          break;
-        case AR_OBJECT_RAYTRACING_PIPELINE_CONFIG:
-          recordDecl = CreateSubobjectRaytracingPipelineConfig(*m_context);
-          break;
-        case AR_OBJECT_TRIANGLE_HIT_GROUP:
-          recordDecl = CreateSubobjectTriangleHitGroup(*m_context);
-          break;
-        case AR_OBJECT_PROCEDURAL_PRIMITIVE_HIT_GROUP:
-          recordDecl = CreateSubobjectProceduralPrimitiveHitGroup(*m_context);
-          break;
-        case AR_OBJECT_RAYTRACING_PIPELINE_CONFIG1:
-          recordDecl = CreateSubobjectRaytracingPipelineConfig1(*m_context);
-          break;
-        }
-      } else if (kind == AR_OBJECT_RAY_QUERY) {
-        recordDecl = DeclareRayQueryType(*m_context);
-      } else if (kind == AR_OBJECT_RESOURCE) {
-        recordDecl = DeclareResourceType(*m_context);
-      }
-      else if (kind == AR_OBJECT_FEEDBACKTEXTURE2D) {
-        recordDecl = DeclareUIntTemplatedTypeWithHandle(*m_context, "FeedbackTexture2D", "kind");
-      }
-      else if (kind == AR_OBJECT_FEEDBACKTEXTURE2D_ARRAY) {
-        recordDecl = DeclareUIntTemplatedTypeWithHandle(*m_context, "FeedbackTexture2DArray", "kind");
-      }
-      else if (templateArgCount == 0) {
-        recordDecl = DeclareRecordTypeWithHandle(*m_context, typeName);
-      }
-      else
-      {
-        DXASSERT(templateArgCount == 1 || templateArgCount == 2, "otherwise a new case has been added");
-
-        TypeSourceInfo* typeDefault = TemplateHasDefaultType(kind) ? float4TypeSourceInfo : nullptr;
-        recordDecl = DeclareTemplateTypeWithHandle(*m_context, typeName, templateArgCount, typeDefault);
-      }
-      m_objectTypeDecls[i] = recordDecl;
-      m_objectTypeDeclsMap[i] = std::make_pair(recordDecl, i);
-      m_objectTypeLazyInitMask |= ((uint64_t)1)<<i;
     }
 
     // Create an alias for SamplerState. 'sampler' is very commonly used.
@@ -3365,7 +3454,6 @@ private:
       samplerDecl->setImplicit(true);
 
       // Create decls for each deprecated effect object type:
-      unsigned effectObjBase = _countof(g_ArBasicKindsAsTypes);
       // TypeSourceInfo* effectObjTypeSource = m_context->getTrivialTypeSourceInfo(GetBasicKindType(AR_OBJECT_LEGACY_EFFECT));
       for (unsigned i = 0; i < _countof(g_DeprecatedEffectObjectNames); i++) {
         IdentifierInfo& idInfo = m_context->Idents.get(StringRef(g_DeprecatedEffectObjectNames[i]), tok::TokenKind::identifier);
@@ -3373,12 +3461,9 @@ private:
         CXXRecordDecl *effectObjDecl = CXXRecordDecl::Create(*m_context, TagTypeKind::TTK_Struct, currentDeclContext, NoLoc, NoLoc, &idInfo);
         currentDeclContext->addDecl(effectObjDecl);
         effectObjDecl->setImplicit(true);
-        m_objectTypeDeclsMap[i+effectObjBase] = std::make_pair(effectObjDecl, effectKindIndex);
+        m_objectTypeDeclsMap[effectObjDecl] = effectKindIndex;
       }
     }
-
-    // Make sure it's in order.
-    std::sort(m_objectTypeDeclsMap.begin(), m_objectTypeDeclsMap.end(), ObjectTypeDeclMapTypeCmp);
   }
 
   FunctionDecl* AddSubscriptSpecialization(
@@ -3432,7 +3517,8 @@ public:
     m_vectorTemplateDecl(nullptr),
     m_context(nullptr),
     m_sema(nullptr),
-    m_hlslStringTypedef(nullptr)
+    m_hlslStringTypedef(nullptr),
+    m_declaringObjectType(false)
   {
     memset(m_matrixTypes, 0, sizeof(m_matrixTypes));
     memset(m_matrixShorthandTypes, 0, sizeof(m_matrixShorthandTypes));
@@ -3441,6 +3527,7 @@ public:
     memset(m_scalarTypes, 0, sizeof(m_scalarTypes));
     memset(m_scalarTypeDefs, 0, sizeof(m_scalarTypeDefs));
     memset(m_baseTypes, 0, sizeof(m_baseTypes));
+    memset(m_objectTypeDecls, 0, sizeof(m_objectTypeDecls));
   }
 
   ~HLSLExternalSource() { }
@@ -3463,9 +3550,6 @@ public:
 
     AddObjectTypes();
     AddStdIsEqualImplementation(S.getASTContext(), S);
-    for (auto && intrinsic : m_intrinsicTables) {
-      AddIntrinsicTableMethods(intrinsic);
-    }
   }
 
   void ForgetSema() override
@@ -3650,6 +3734,41 @@ public:
     return false;
   }
 
+  // Declares the built-in object type with the given name on its first lookup
+  // in the translation unit. The new declaration is added to the translation
+  // unit, where the lookup that called this finds it.
+  bool FindExternalVisibleDeclsByName(const DeclContext *DC,
+                                      DeclarationName Name) override
+  {
+    if (!DC->isTranslationUnit() || m_declaringObjectType) {
+      return false;
+    }
+    IdentifierInfo *idInfo = Name.getAsIdentifierInfo();
+    if (idInfo == nullptr) {
+      return false;
+    }
+    int index = FindObjectBasicKindIndexByName(idInfo->getName());
+    if (index == -1 || m_objectTypeDecls[index] != nullptr) {
+      return false;
+    }
+    GetObjectTypeDecl(index);
+    return true;
+  }
+
+  // Declares all remaining built-in object types when every name visible in
+  // the translation unit is needed, e.g. for code completion.
+  void completeVisibleDeclsMap(const DeclContext *DC) override
+  {
+    if (!DC->isTranslationUnit() || m_declaringObjectType) {
+      return;
+    }
+    for (unsigned i = 0; i < _countof(g_ArBasicKindsAsTypes); i++) {
+      if (IsNamedObjectType(i)) {
+        GetObjectTypeDecl(i);
+      }
+    }
+  }
+
   /// <summary>
   /// Determines whether the specify record type is a matrix, another HLSL object, or a user-defined structure.
   /// </sumary>
@@ -3877,48 +3996,54 @@ public:
     return AR_BASIC_UNKNOWN;
   }
 
+  // Adds the methods table has for the object type at index i of
+  // g_ArBasicKindsAsTypes.
+  void AddIntrinsicTableMethods(_In_ IDxcIntrinsicTable *table, unsigned i) {
+    DXASSERT_NOMSG(table != nullptr);
+
+    // Grab information already processed by GetObjectTypeDecl.
+    ArBasicKind kind = g_ArBasicKindsAsTypes[i];
+    const char *typeName = g_ArBasicTypeNames[kind];
+    uint8_t templateArgCount = g_ArBasicKindsTemplateCount[i];
+    DXASSERT(templateArgCount <= 2, "otherwise a new case has been added");
+    int startDepth = (templateArgCount == 0) ? 0 : 1;
+    CXXRecordDecl *recordDecl = m_objectTypeDecls[i];
+    DXASSERT(recordDecl != nullptr, "else object type not declared yet");
+
+    // This is a variation of AddObjectMethods using the new table.
+    const HLSL_INTRINSIC *pIntrinsic = nullptr;
+    const HLSL_INTRINSIC *pPrior = nullptr;
+    UINT64 lookupCookie = 0;
+    CA2W wideTypeName(typeName, CP_UTF8);
+    HRESULT found = table->LookupIntrinsic(wideTypeName, L"*", &pIntrinsic, &lookupCookie);
+    while (pIntrinsic != nullptr && SUCCEEDED(found)) {
+      if (!AreIntrinsicTemplatesEquivalent(pIntrinsic, pPrior)) {
+        AddObjectIntrinsicTemplate(recordDecl, startDepth, pIntrinsic);
+        // NOTE: this only works with the current implementation because
+        // intrinsics are alive as long as the table is alive.
+        pPrior = pIntrinsic;
+      }
+      found = table->LookupIntrinsic(wideTypeName, L"*", &pIntrinsic, &lookupCookie);
+    }
+  }
+
   void AddIntrinsicTableMethods(_In_ IDxcIntrinsicTable *table) {
     DXASSERT_NOMSG(table != nullptr);
 
     // Function intrinsics are added on-demand, objects get template methods.
+    // Object types declared later get them from GetObjectTypeDecl.
     for (unsigned i = 0; i < _countof(g_ArBasicKindsAsTypes); i++) {
-      // Grab information already processed by AddObjectTypes.
-      ArBasicKind kind = g_ArBasicKindsAsTypes[i];
-      const char *typeName = g_ArBasicTypeNames[kind];
-      uint8_t templateArgCount = g_ArBasicKindsTemplateCount[i];
-      DXASSERT(templateArgCount <= 2, "otherwise a new case has been added");
-      int startDepth = (templateArgCount == 0) ? 0 : 1;
-      CXXRecordDecl *recordDecl = m_objectTypeDecls[i];
-      if (recordDecl == nullptr) {
-        DXASSERT(kind == AR_OBJECT_WAVE, "else objects other than reserved not initialized");
-        continue;
-      }
-
-      // This is a variation of AddObjectMethods using the new table.
-      const HLSL_INTRINSIC *pIntrinsic = nullptr;
-      const HLSL_INTRINSIC *pPrior = nullptr;
-      UINT64 lookupCookie = 0;
-      CA2W wideTypeName(typeName, CP_UTF8);
-      HRESULT found = table->LookupIntrinsic(wideTypeName, L"*", &pIntrinsic, &lookupCookie);
-      while (pIntrinsic != nullptr && SUCCEEDED(found)) {
-        if (!AreIntrinsicTemplatesEquivalent(pIntrinsic, pPrior)) {
-          AddObjectIntrinsicTemplate(recordDecl, startDepth, pIntrinsic);
-          // NOTE: this only works with the current implementation because
-          // intrinsics are alive as long as the table is alive.
-          pPrior = pIntrinsic;
-        }
-        found = table->LookupIntrinsic(wideTypeName, L"*", &pIntrinsic, &lookupCookie);
-      }
+      if (m_objectTypeDecls[i] != nullptr)
+        AddIntrinsicTableMethods(table, i);
     }
   }
 
   void RegisterIntrinsicTable(_In_ IDxcIntrinsicTable *table) {
     DXASSERT_NOMSG(table != nullptr);
     m_intrinsicTables.push_back(table);
-    // If already initialized, add methods immediately.
-    if (m_sema != nullptr) {
-      AddIntrinsicTableMethods(table);
-    }
+    // Add methods to the object types declared so far; the others get them
+    // when they are declared.
+    AddIntrinsicTableMethods(table);
   }
 
   HLSLScalarType ScalarTypeForBasic(ArBasicKind kind)
@@ -4031,7 +4156,7 @@ public:
         const ArBasicKind* match = std::find(g_ArBasicKindsAsTypes, &g_ArBasicKindsAsTypes[_countof(g_ArBasicKindsAsTypes)], kind);
         DXASSERT(match != &g_ArBasicKindsAsTypes[_countof(g_ArBasicKindsAsTypes)], "otherwise can't find constant in basic kinds");
         size_t index = match - g_ArBasicKindsAsTypes;
-        return m_context->getTagDeclType(this->m_objectTypeDecls[index]);
+        return m_context->getTagDeclType(GetObjectTypeDecl(index));
     }
 
     case AR_OBJECT_SAMPLER1D:
@@ -4156,30 +4281,23 @@ public:
     StringRef nameIdentifier,
     size_t argumentCount)
   {
-    // This is implemented by a linear scan for now.
-    // We tested binary search on tables, and there was no performance gain on
-    // samples probably for the following reasons.
-    // 1. The tables are not big enough to make noticable difference
-    // 2. The user of this function assumes that it returns the first entry in
-    // the table that matches name and argument count. So even in the binary
-    // search, we have to scan backwards until the entry does not match the name
-    // or arg count. For linear search this is not a problem
-    for (unsigned int i = 0; i < tableSize; i++) {
-      const HLSL_INTRINSIC* pIntrinsic = &table[i];
-
-      // Do some quick checks to verify size and name.
-      if (pIntrinsic->uNumArgs != 1 + argumentCount) {
-        continue;
-      }
-      if (!nameIdentifier.equals(StringRef(pIntrinsic->pArgs[0].pName))) {
-        continue;
+    // A linear scan was fast enough for samples, but code with many intrinsic
+    // calls searched g_Intrinsics once per call; look the name up in the
+    // table's index instead. The index keeps the first entry for the name and
+    // argument count, which is what callers iterate from.
+    const HLSL_INTRINSIC *pFirst = table + tableSize;
+    const IntrinsicTableIndex &index = GetIntrinsicTableIndex(table, tableSize);
+    auto it = index.find(nameIdentifier);
+    if (it != index.end()) {
+      for (const std::pair<unsigned, unsigned> &entry : it->second) {
+        if (entry.first == 1 + argumentCount) {
+          pFirst = table + entry.second;
+          break;
+        }
       }
-
-      return IntrinsicDefIter::CreateStart(table, tableSize, pIntrinsic,
-        IntrinsicTableDefIter::CreateStart(m_intrinsicTables, typeName, nameIdentifier, argumentCount));
     }
 
-    return IntrinsicDefIter::CreateStart(table, tableSize, table + tableSize,
+    return IntrinsicDefIter::CreateStart(table, tableSize, pFirst,
       IntrinsicTableDefIter::CreateStart(m_intrinsicTables, typeName, nameIdentifier, argumentCount));
   }
 
@@ -4206,6 +4324,30 @@ public:
 
     StringRef nameIdentifier = idInfo->getName();
 
+    // Calls with the same name and argument types resolve to the same
+    // intrinsic overload, so reuse an earlier result when there is one.
+    // Literal arguments are excluded because their concrete type depends on
+    // the value, and so are calls matched while diagnosing errors.
+    IntrinsicCallKey callKey;
+    callKey.push_back(idInfo);
+    for (Expr *pArg : Args) {
+      QualType argType = pArg->getType();
+      ArBasicKind eltKind = GetTypeElementKind(argType);
+      if (pArg->isTypeDependent() || eltKind == AR_BASIC_LITERAL_INT ||
+          eltKind == AR_BASIC_LITERAL_FLOAT) {
+        callKey.clear();
+        break;
+      }
+      callKey.push_back(argType.getCanonicalType().getAsOpaquePtr());
+    }
+    if (!callKey.empty()) {
+      auto memoIt = m_intrinsicCallMemo.find(callKey);
+      if (memoIt != m_intrinsicCallMemo.end()) {
+        AddIntrinsicCandidate(CandidateSet, memoIt->second);
+        return true;
+      }
+    }
+
     IntrinsicDefIter cursor = FindIntrinsicByNameAndArgCount(
       g_Intrinsics, _countof(g_Intrinsics), StringRef(), nameIdentifier, Args.size());
     IntrinsicDefIter end = IntrinsicDefIter::CreateEnd(
@@ -4244,17 +4386,24 @@ public:
         intrinsicFuncDecl = (*insertResult.first).getFunctionDecl();
       }
 
-      OverloadCandidate& candidate = CandidateSet.addCandidate();
-      candidate.Function = intrinsicFuncDecl;
-      candidate.FoundDecl.setDecl(intrinsicFuncDecl);
-      candidate.Viable = true;
+      if (!callKey.empty() && !m_sema->getDiagnostics().hasErrorOccurred())
+        m_intrinsicCallMemo[callKey] = intrinsicFuncDecl;
 
+      AddIntrinsicCandidate(CandidateSet, intrinsicFuncDecl);
       return true;
     }
 
     return false;
   }
 
+  void AddIntrinsicCandidate(OverloadCandidateSet &CandidateSet,
+                             FunctionDecl *intrinsicFuncDecl) {
+    OverloadCandidate& candidate = CandidateSet.addCandidate();
+    candidate.Function = intrinsicFuncDecl;
+    candidate.FoundDecl.setDecl(intrinsicFuncDecl);
+    candidate.Viable = true;
+  }
+
   bool Initialize(ASTContext& context)
   {
     m_context = &context;
@@ -6070,22 +6219,32 @@ ExprResult HLSLExternalSource::PromoteToIntIfBool(ExprResult& E)
   return E;
 }
 
+HLSLExternalSource::TypeInfoRecord &
+HLSLExternalSource::GetTypeInfoRecord(QualType type) {
+  // Everything recorded is a property of the structural form, so sugared,
+  // qualified and reference forms of a type share one record.
+  QualType structuralType = GetStructuralForm(type);
+  auto insertResult = m_typeInfoRecords.insert(
+      std::make_pair(structuralType.getTypePtr(), TypeInfoRecord()));
+  TypeInfoRecord &record = insertResult.first->second;
+  if (insertResult.second) {
+    ArTypeInfo &info = record.Info;
+    info.ObjKind = GetTypeElementKind(structuralType);
+    info.EltKind = info.ObjKind;
+    info.ShapeKind = GetTypeObjectKind(structuralType);
+    GetRowsAndColsForAny(structuralType, info.uRows, info.uCols);
+    info.uTotalElts = info.uRows * info.uCols;
+  }
+  return record;
+}
+
 _Use_decl_annotations_
 void HLSLExternalSource::CollectInfo(QualType type, ArTypeInfo* pTypeInfo)
 {
   DXASSERT_NOMSG(pTypeInfo != nullptr);
   DXASSERT_NOMSG(!type.isNull());
 
-  memset(pTypeInfo, 0, sizeof(*pTypeInfo));
-
-  // TODO: Get* functions used here add up to a bunch of redundant code.
-  //       Try to inline that here, making it cheaper to use this function
-  //       when retrieving multiple properties.
-  pTypeInfo->ObjKind = GetTypeElementKind(type);
-  pTypeInfo->EltKind = pTypeInfo->ObjKind;
-  pTypeInfo->ShapeKind = GetTypeObjectKind(type);
-  GetRowsAndColsForAny(type, pTypeInfo->uRows, pTypeInfo->uCols);
-  pTypeInfo->uTotalElts = pTypeInfo->uRows * pTypeInfo->uCols;
+  *pTypeInfo = GetTypeInfoRecord(type).Info;
 }
 
 // Highest possible score (i.e., worst possible score).
@@ -7079,10 +7238,47 @@ bool HLSLExternalSource::IsTypeNumeric(QualType type, UINT* count)
   DXASSERT_NOMSG(count != nullptr);
 
   *count = 0;
-  UINT subCount = 0;
   ArTypeObjectKind shapeKind = GetTypeObjectKind(type);
   switch (shapeKind)
   {
+  case AR_TOBJ_ARRAY:
+  case AR_TOBJ_COMPOUND:
+    {
+      // Flattening a struct is costly; remember the result for complete types.
+      auto recordIt = m_typeInfoRecords.find(GetStructuralForm(type).getTypePtr());
+      if (recordIt != m_typeInfoRecords.end() && recordIt->second.NumericKnown) {
+        *count = recordIt->second.NumericCount;
+        return recordIt->second.Numeric;
+      }
+      bool numeric = IsAggregateTypeNumeric(type, count);
+      if (!type->isIncompleteType()) {
+        // Looked up again, as recursive calls may have grown the map.
+        TypeInfoRecord &record = GetTypeInfoRecord(type);
+        record.NumericKnown = true;
+        record.Numeric = numeric;
+        record.NumericCount = *count;
+      }
+      return numeric;
+    }
+  default:
+    DXASSERT(false, "unreachable");
+  case AR_TOBJ_BASIC:
+  case AR_TOBJ_MATRIX:
+  case AR_TOBJ_VECTOR:
+    *count = GetElementCount(type);
+    return IsBasicKindNumeric(GetTypeElementKind(type));
+  case AR_TOBJ_OBJECT:
+  case AR_TOBJ_STRING:
+    return false;
+  }
+}
+
+bool HLSLExternalSource::IsAggregateTypeNumeric(QualType type, UINT* count)
+{
+  *count = 0;
+  UINT subCount = 0;
+  switch (GetTypeObjectKind(type))
+  {
   case AR_TOBJ_ARRAY:
     if (IsTypeNumeric(m_context->getAsArrayType(type)->getElementType(), &subCount))
     {
@@ -7117,14 +7313,7 @@ bool HLSLExternalSource::IsTypeNumeric(QualType type, UINT* count)
       return true;
     }
   default:
-    DXASSERT(false, "unreachable");
-  case AR_TOBJ_BASIC:
-  case AR_TOBJ_MATRIX:
-  case AR_TOBJ_VECTOR:
-    *count = GetElementCount(type);
-    return IsBasicKindNumeric(GetTypeElementKind(type));
-  case AR_TOBJ_OBJECT:
-  case AR_TOBJ_STRING:
+    DXASSERT(false, "otherwise type is not an array or struct");
     return false;
   }
 }
@@ -0,0 +1,50 @@
+// Run: %dxc -T ps_6_0 -E main
+
+// 50,000 if statements in a row give a function of about 100,000 blocks, with
+// each merge block nested one level deeper in the structured control flow
+// than the previous one. Checks that the blocks are still laid out in
+// readable order without exhausting the stack.
+
+#define IF_STMT(i) if (x > i) r += i;
+#define R10(F, i) F(i##0) F(i##1) F(i##2) F(i##3) F(i##4) \
+                  F(i##5) F(i##6) F(i##7) F(i##8) F(i##9)
+#define R100(F, i) R10(F, i##0) R10(F, i##1) R10(F, i##2) R10(F, i##3) \
+                   R10(F, i##4) R10(F, i##5) R10(F, i##6) R10(F, i##7) \
+                   R10(F, i##8) R10(F, i##9)
+#define R1000(F, i) R100(F, i##0) R100(F, i##1) R100(F, i##2) R100(F, i##3) \
+                    R100(F, i##4) R100(F, i##5) R100(F, i##6) R100(F, i##7) \
+                    R100(F, i##8) R100(F, i##9)
+#define R10000(F, i) R1000(F, i##0) R1000(F, i##1) R1000(F, i##2)           \
+                     R1000(F, i##3) R1000(F, i##4) R1000(F, i##5)           \
+                     R1000(F, i##6) R1000(F, i##7) R1000(F, i##8)           \
+                     R1000(F, i##9)
+
+float main(int x : X) : SV_Target {
+// CHECK-LABEL: %bb_entry = OpLabel
+  float r = 0;
+
+// CHECK:      OpSelectionMerge %if_merge None
+// CHECK-NEXT: OpBranchConditional {{%\d+}} %if_true %if_merge
+// CHECK:      %if_true = OpLabel
+// CHECK:      OpBranch %if_merge
+// CHECK-NEXT: %if_merge = OpLabel
+// CHECK:      OpSelectionMerge %if_merge_0 None
+// CHECK-NEXT: OpBranchConditional {{%\d+}} %if_true_0 %if_merge_0
+// CHECK:      %if_true_0 = OpLabel
+// CHECK:      OpBranch %if_merge_0
+// CHECK-NEXT: %if_merge_0 = OpLabel
+  R10000(IF_STMT, 1)
+  R10000(IF_STMT, 2)
+  R10000(IF_STMT, 3)
+  R10000(IF_STMT, 4)
+  R10000(IF_STMT, 5)
+
+// CHECK:      OpSelectionMerge %if_merge_49998 None
+// CHECK-NEXT: OpBranchConditional {{%\d+}} %if_true_49998 %if_merge_49998
+// CHECK:      %if_true_49998 = OpLabel
+// CHECK:      OpBranch %if_merge_49998
+// CHECK-NEXT: %if_merge_49998 = OpLabel
+// CHECK:      OpReturnValue
+// CHECK-NEXT: OpFunctionEnd
+  return r;
+}
@@ -0,0 +1,19 @@
+// Run: %dxc -T ps_6_0 -E main -fspv-time-report
+
+// Make sure -fspv-time-report reports each pass over the in-memory module, and
+// then the AST translation. Timers within a group are listed by the time they
+// took, so their order is not fixed. -fcgl and -Vd leave the legalization,
+// optimization and validation timers unstarted, so they are not reported.
+//
+// CHECK:     SPIR-V Visitors
+// CHECK-DAG: Literal types
+// CHECK-DAG: Lower types
+// CHECK-DAG: Capabilities, RelaxedPrecision, BufferBlock
+// CHECK-DAG: NoContraction
+// CHECK-DAG: Emit
+// CHECK:     SPIR-V CodeGen
+// CHECK:     AST translation
+
+float4 main(float4 color : COLOR) : SV_Target {
+  return color;
+}
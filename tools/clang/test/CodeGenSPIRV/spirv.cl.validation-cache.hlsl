@@ -0,0 +1,12 @@
+// Run: %dxc -T ps_6_0 -E main -fspv-validation-cache
+
+// CHECK: OpEntryPoint Fragment %main "main"
+
+cbuffer MyCBuffer {
+  float  a;
+  float4 b;
+};
+
+float4 main() : SV_Target {
+  return a * b;
+}
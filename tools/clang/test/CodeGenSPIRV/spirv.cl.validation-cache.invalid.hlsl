@@ -0,0 +1,18 @@
+// Run: %dxc -T ps_6_0 -E main -fspv-validation-cache
+
+// Make sure a module that fails validation is never recorded as validated, so
+// that compiling it again still reports the error.
+//
+// CHECK: fatal error: generated SPIR-V is invalid:
+// CHECK-SAME: layout rules
+
+cbuffer MyCBuffer {
+  float  a;
+  // Straddles a 16-byte boundary, which the relaxed layout rules forbid.
+  [[vk::offset(4)]]
+  float4 b;
+};
+
+float4 main() : SV_Target {
+  return a * b;
+}
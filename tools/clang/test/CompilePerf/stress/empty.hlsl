@@ -0,0 +1,5 @@
+// Smallest possible pixel shader; measures fixed per-compile overhead.
+
+float4 main() : SV_Target {
+  return 0;
+}
@@ -0,0 +1,27 @@
+// Large initializer lists and vector/matrix arithmetic; stresses HLSL type
+// info collection during conversion checks and initializer-list processing.
+#include "repeat.h"
+
+float4 v;
+float3x3 n;
+
+struct Item {
+  float4 pos;
+  float3x3 basis;
+  int2 index;
+  float weight;
+};
+
+#define INIT_OPS(i)                                                           \
+  {                                                                           \
+    Item it = { v * i, n, int2(i, -i), v.x };                                 \
+    float4x4 t = { it.pos, it.pos.yzwx, float4(it.index, 1, 2), v };          \
+    float2x2 s = { it.basis._m00_m11, (float2)it.weight };                    \
+    acc += mul(t, it.pos) + float4(mul(s, it.pos.xy), it.basis[1].xy);        \
+  }
+
+float4 main() : SV_Target {
+  float4 acc = 0;
+  REPEAT900(INIT_OPS)
+  return acc;
+}
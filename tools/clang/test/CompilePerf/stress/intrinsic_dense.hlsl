@@ -0,0 +1,19 @@
+// Thousands of intrinsic calls in one function; stresses intrinsic lookup and
+// overload resolution in Sema as well as intrinsic lowering.
+#include "repeat.h"
+
+float4 a;
+float4 b;
+float4x4 m;
+Texture2D<float4> tex;
+SamplerState samp;
+
+#define INTRINSIC_OPS(i)                                                      \
+  r += mul(m, a * i) + sin(b) * cos(r) + lerp(a, b, saturate(r.x));          \
+  r = max(abs(r), dot(a, r)) + tex.Sample(samp, frac(r.xy * i));
+
+float4 main() : SV_Target {
+  float4 r = 0;
+  REPEAT900(INTRINSIC_OPS)
+  return r;
+}
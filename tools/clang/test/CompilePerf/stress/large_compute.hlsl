@@ -0,0 +1,33 @@
+// A large compute shader: thousands of named locals, buffer accesses and
+// groupshared traffic in one entry point. Used to track peak memory of the
+// SPIR-V backend, where every expression becomes a SpirvInstruction that
+// lives until the end of the compile.
+#include "repeat.h"
+
+struct Particle {
+  float4 position;
+  float4 velocity;
+  uint flags;
+};
+
+RWStructuredBuffer<Particle> particles;
+StructuredBuffer<float4> forces;
+groupshared float4 tile[64];
+
+#define COMPUTE_OPS(i)                                                        \
+  float4 f##i = forces[(id.x + i) % 1024];                                    \
+  Particle p##i = particles[(id.x * i) % 4096];                               \
+  p##i.velocity += f##i * dt;                                                 \
+  p##i.position += p##i.velocity * dt;                                        \
+  tile[gi] = p##i.position;                                                   \
+  GroupMemoryBarrierWithGroupSync();                                          \
+  acc += tile[(gi + i) % 64] * (p##i.flags & i ? 1.0 : 0.5);                  \
+  particles[(id.x * i) % 4096] = p##i;
+
+[numthreads(64, 1, 1)]
+void main(uint3 id : SV_DispatchThreadID, uint gi : SV_GroupIndex) {
+  const float dt = 0.016;
+  float4 acc = 0;
+  REPEAT900(COMPUTE_OPS)
+  particles[id.x].position = acc;
+}
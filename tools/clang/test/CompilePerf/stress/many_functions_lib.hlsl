@@ -0,0 +1,16 @@
+// A library with hundreds of independent exported functions, the shape of
+// large DXR libraries compiled for lib_6_x.
+#include "repeat.h"
+
+RWByteAddressBuffer output;
+
+#define EXPORTED_FN(i)                                                        \
+  export float4 fn##i(float4 x, uint idx) {                                   \
+    float4 r = x * i;                                                         \
+    for (uint j = 0; j < idx; ++j)                                            \
+      r = r * r.yzwx + sin(r);                                                \
+    output.Store4(idx * 16, asuint(r));                                       \
+    return r;                                                                 \
+  }
+
+REPEAT900(EXPORTED_FN)
@@ -0,0 +1,25 @@
+// Hundreds of distinct struct types and constant composites; stresses type
+// and constant uniquing in the SPIR-V back end.
+#include "repeat.h"
+
+#define DECLARE_STRUCT(i)                                                     \
+  struct S##i {                                                               \
+    float4 a##i;                                                              \
+    int b##i[2];                                                              \
+    float3x3 c##i;                                                            \
+  };
+REPEAT900(DECLARE_STRUCT)
+
+#define DECLARE_FIELD(i) S##i s##i;
+cbuffer Materials {
+  REPEAT900(DECLARE_FIELD)
+};
+
+#define USE_FIELD(i)                                                          \
+  r += s##i.a##i * float4(i, i + 1, i + 2, i + 3) + s##i.b##i[1];
+
+float4 main() : SV_Target {
+  float4 r = 0;
+  REPEAT900(USE_FIELD)
+  return r;
+}
@@ -0,0 +1,12 @@
+// Repetition helpers for the synthetic stress shaders.
+// REPEAT900(F) expands to F(100) F(101) ... F(999); the numbers never start
+// with 0 so that they are valid decimal literals.
+#define REPEAT10(F, i) F(i##0) F(i##1) F(i##2) F(i##3) F(i##4) \
+                       F(i##5) F(i##6) F(i##7) F(i##8) F(i##9)
+#define REPEAT100(F, i) REPEAT10(F, i##0) REPEAT10(F, i##1) REPEAT10(F, i##2) \
+                        REPEAT10(F, i##3) REPEAT10(F, i##4) REPEAT10(F, i##5) \
+                        REPEAT10(F, i##6) REPEAT10(F, i##7) REPEAT10(F, i##8) \
+                        REPEAT10(F, i##9)
+#define REPEAT900(F) REPEAT100(F, 1) REPEAT100(F, 2) REPEAT100(F, 3) \
+                     REPEAT100(F, 4) REPEAT100(F, 5) REPEAT100(F, 6) \
+                     REPEAT100(F, 7) REPEAT100(F, 8) REPEAT100(F, 9)
@@ -0,0 +1,47 @@
+// RUN: %clang_cc1 -Wno-unused-value -fsyntax-only -ffreestanding -verify -verify-ignore-unexpected=note %s
+
+// Built-in object types are declared on first lookup; every kind of lookup
+// must find them.
+
+// Qualified lookup in the global namespace.
+::Texture2D<float4> g_tex;
+::RWStructuredBuffer<uint> g_buf;
+::SamplerState g_samp;
+
+float4 QualifiedRayDesc() {
+  ::RayDesc ray;
+  ray.Origin = float3(0, 0, 0);
+  ray.TMin = 0;
+  return ray.TMin;
+}
+
+// Unqualified and qualified lookup from inside a namespace.
+namespace N {
+  Texture3D<float> tex3d;
+  ::ByteAddressBuffer bab;
+  float Load(uint addr) { return asfloat(bab.Load(addr)) + tex3d.Load(int4(0, 0, 0, 0)); }
+}
+
+// A user type in a namespace may reuse a built-in name; it hides the
+// built-in type there.
+namespace U {
+  struct Buffer { float4 v; };
+  float4 Get(Buffer b) { return b.v; }
+}
+
+float4 UseUserBuffer() {
+  U::Buffer b;
+  b.v = float4(1, 2, 3, 4);
+  ::Buffer<float4> builtin;
+  return U::Get(b) + builtin[0];
+}
+
+// Redeclaring a built-in type in the global namespace is an error, whether or
+// not the built-in type has been used before.
+struct Texture2DArray { int x; };   // expected-error {{redefinition of 'Texture2DArray' as different kind of symbol}}
+struct Texture2D { int x; };        // expected-error {{redefinition of 'Texture2D' as different kind of symbol}}
+
+float4 main() : SV_Target {
+  return g_tex.Sample(g_samp, float2(0, 0)) + N::Load(0) + UseUserBuffer() +
+         QualifiedRayDesc() + g_buf[0];
+}
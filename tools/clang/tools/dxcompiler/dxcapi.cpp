@@ -45,6 +45,7 @@ DEFINE_CROSS_PLATFORM_UUIDOF(IDxcRewriter)
 DEFINE_CROSS_PLATFORM_UUIDOF(IDxcRewriter2)
 DEFINE_CROSS_PLATFORM_UUIDOF(IDxcIntelliSense)
 DEFINE_CROSS_PLATFORM_UUIDOF(IDxcLinker)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcLinker2)
 DEFINE_CROSS_PLATFORM_UUIDOF(IDxcBlobUtf16)
 DEFINE_CROSS_PLATFORM_UUIDOF(IDxcBlobUtf8)
 DEFINE_CROSS_PLATFORM_UUIDOF(IDxcCompilerArgs)
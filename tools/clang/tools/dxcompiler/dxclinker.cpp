@@ -21,6 +21,8 @@
 
 #include "llvm/ADT/SmallVector.h"
 #include <algorithm>
+#include <deque>
+#include <unordered_map>
 
 #include "dxc/HLSL/DxilLinker.h"
 #include "dxc/HLSL/DxilValidation.h"
@@ -43,7 +45,7 @@ using namespace llvm;
 // This declaration is used for the locally-linked validator.
 HRESULT CreateDxcValidator(_In_ REFIID riid, _Out_ LPVOID *ppv);
 
-class DxcLinker : public IDxcLinker, public IDxcContainerEvent {
+class DxcLinker : public IDxcLinker2, public IDxcContainerEvent {
 public:
   DXC_MICROCOM_TM_ADDREF_RELEASE_IMPL()
   DXC_MICROCOM_TM_CTOR(DxcLinker)
@@ -69,6 +71,17 @@ public:
           *ppResult // Linker output status, buffer, and errors
   ) override;
 
+  // Links several outputs against the same libraries.
+  HRESULT STDMETHODCALLTYPE LinkMultiple(
+      _In_count_(outputCount) const LPCWSTR *pEntryNames,
+      _In_count_(outputCount) const LPCWSTR *pTargetProfiles,
+      _In_opt_count_(outputCount) const LPCWSTR *pExports,
+      _In_ UINT32 outputCount,
+      _In_count_(libCount) const LPCWSTR *pLibNames, _In_ UINT32 libCount,
+      _In_opt_count_(argCount) const LPCWSTR *pArguments,
+      _In_ UINT32 argCount,
+      _Out_writes_(outputCount) IDxcOperationResult **ppResults) override;
+
   HRESULT STDMETHODCALLTYPE RegisterDxilContainerEventHandler(
       IDxcContainerEventsHandler *pHandler, UINT64 *pCookie) override {
     DxcThreadMalloc TM(m_pMalloc);
@@ -88,7 +101,8 @@ public:
   }
 
   HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppvObject) {
-    return DoBasicQueryInterface<IDxcLinker>(this, riid, ppvObject);
+    return DoBasicQueryInterface<IDxcLinker, IDxcLinker2>(this, riid,
+                                                          ppvObject);
   }
 
   void Initialize() {
@@ -103,13 +117,58 @@ public:
   }
 
 private:
+  // Links one output. Libraries are (re)attached when bAttachLibs is set;
+  // bAttached reports whether they are attached afterwards.
+  HRESULT LinkOutput(LPCWSTR pEntryName, LPCWSTR pTargetProfile,
+                     LPCWSTR pExports, const LPCWSTR *pLibNames,
+                     UINT32 libCount, const LPCWSTR *pArguments,
+                     UINT32 argCount, bool bAttachLibs, bool &bAttached,
+                     IDxcOperationResult **ppResult);
+
+  // Records a successful link result, evicting the oldest ones to keep the
+  // cache within its bounds.
+  void AddToLinkCache(const std::string &key, IDxcBlob *pContainer,
+                      std::string warnings);
+
   DXC_MICROCOM_TM_REF_FIELDS()
   LLVMContext m_Ctx;
   std::unique_ptr<DxilLinker> m_pLinker;
   CComPtr<IDxcContainerEventsHandler> m_pDxcContainerEventsHandler;
   std::vector<CComPtr<IDxcBlob>> m_blobs; // Keep blobs live for lazy load.
+
+  // Successful link results by DxilLinker::GetLinkKey plus the arguments.
+  // Bounded both in entries and in container bytes.
+  struct LinkCacheEntry {
+    CComPtr<IDxcBlob> pContainer; // Before the container events handler ran.
+    std::string warnings;
+  };
+  static const size_t kMaxLinkCacheEntries = 64;
+  static const size_t kMaxLinkCacheBytes = 64 * 1024 * 1024;
+  std::unordered_map<std::string, LinkCacheEntry> m_linkCache;
+  std::deque<std::string> m_linkCacheOrder; // Keys, oldest first.
+  size_t m_linkCacheBytes = 0;
 };
 
+void DxcLinker::AddToLinkCache(const std::string &key, IDxcBlob *pContainer,
+                               std::string warnings) {
+  size_t size = pContainer->GetBufferSize();
+  if (size > kMaxLinkCacheBytes || m_linkCache.count(key))
+    return;
+  while (!m_linkCacheOrder.empty() &&
+         (m_linkCache.size() >= kMaxLinkCacheEntries ||
+          m_linkCacheBytes + size > kMaxLinkCacheBytes)) {
+    auto it = m_linkCache.find(m_linkCacheOrder.front());
+    m_linkCacheBytes -= it->second.pContainer->GetBufferSize();
+    m_linkCache.erase(it);
+    m_linkCacheOrder.pop_front();
+  }
+  LinkCacheEntry &entry = m_linkCache[key];
+  entry.pContainer = pContainer;
+  entry.warnings = std::move(warnings);
+  m_linkCacheOrder.push_back(key);
+  m_linkCacheBytes += size;
+}
+
 HRESULT
 DxcLinker::RegisterLibrary(_In_opt_ LPCWSTR pLibName, // Name of the library.
                            _In_ IDxcBlob *pBlob       // Library to add.
@@ -125,7 +184,7 @@ DxcLinker::RegisterLibrary(_In_opt_ LPCWSTR pLibName, // Name of the library.
     return E_INVALIDARG;
 
   try {
-    std::unique_ptr<llvm::Module> pModule, pDebugModule;
+    std::unique_ptr<llvm::Module> pModule;
 
     CComPtr<IMalloc> pMalloc;
     CComPtr<AbstractMemoryStream> pDiagStream;
@@ -135,12 +194,14 @@ DxcLinker::RegisterLibrary(_In_opt_ LPCWSTR pLibName, // Name of the library.
 
     raw_stream_ostream DiagStream(pDiagStream);
 
-    IFR(ValidateLoadModuleFromContainerLazy(
-        pBlob->GetBufferPointer(), pBlob->GetBufferSize(), pModule,
-        pDebugModule, m_Ctx, m_Ctx, DiagStream));
+    // The linker links the debug module when there is one, so only that one
+    // is loaded.
+    IFR(ValidateLoadLinkModuleFromContainerLazy(
+        pBlob->GetBufferPointer(), pBlob->GetBufferSize(), pModule, m_Ctx,
+        DiagStream));
 
     if (m_pLinker->RegisterLib(pUtf8LibName.m_psz, std::move(pModule),
-                               std::move(pDebugModule))) {
+                               nullptr)) {
       m_blobs.emplace_back(pBlob);
       return S_OK;
     } else {
@@ -168,15 +229,69 @@ HRESULT STDMETHODCALLTYPE DxcLinker::Link(
   if (!pTargetProfile || !pLibNames || libCount == 0 || !ppResult)
     return E_INVALIDARG;
   DxcThreadMalloc TM(m_pMalloc);
+
+  bool bAttached = false;
+  return LinkOutput(pEntryName, pTargetProfile, /*pExports*/ nullptr,
+                    pLibNames, libCount, pArguments, argCount,
+                    /*bAttachLibs*/ true, bAttached, ppResult);
+}
+
+HRESULT STDMETHODCALLTYPE DxcLinker::LinkMultiple(
+    _In_count_(outputCount) const LPCWSTR *pEntryNames,
+    _In_count_(outputCount) const LPCWSTR *pTargetProfiles,
+    _In_opt_count_(outputCount) const LPCWSTR *pExports,
+    _In_ UINT32 outputCount,
+    _In_count_(libCount) const LPCWSTR *pLibNames, _In_ UINT32 libCount,
+    _In_opt_count_(argCount) const LPCWSTR *pArguments, _In_ UINT32 argCount,
+    _Out_writes_(outputCount) IDxcOperationResult **ppResults) {
+  if (!pEntryNames || !pTargetProfiles || outputCount == 0 || !pLibNames ||
+      libCount == 0 || !ppResults)
+    return E_INVALIDARG;
+  for (UINT32 i = 0; i < outputCount; i++) {
+    if (!pTargetProfiles[i])
+      return E_INVALIDARG;
+    ppResults[i] = nullptr;
+  }
+  DxcThreadMalloc TM(m_pMalloc);
+
+  // Outputs are linked one after another: the libraries and every linked
+  // module share m_Ctx, and an LLVMContext must not be used from several
+  // threads. Keeping the libraries attached between outputs means functions
+  // materialized (and the global usage built) for one output are reused by
+  // the next. If attaching failed, retry per output so that every result
+  // carries the errors.
+  bool bAttached = false;
+  for (UINT32 i = 0; i < outputCount; i++) {
+    HRESULT hr = LinkOutput(pEntryNames[i], pTargetProfiles[i],
+                            pExports ? pExports[i] : nullptr, pLibNames,
+                            libCount, pArguments, argCount,
+                            /*bAttachLibs*/ !bAttached, bAttached,
+                            &ppResults[i]);
+    if (FAILED(hr)) {
+      for (UINT32 j = 0; j < i; j++) {
+        if (ppResults[j]) {
+          ppResults[j]->Release();
+          ppResults[j] = nullptr;
+        }
+      }
+      return hr;
+    }
+  }
+  return S_OK;
+}
+
+HRESULT DxcLinker::LinkOutput(LPCWSTR pEntryName, LPCWSTR pTargetProfile,
+                              LPCWSTR pExports, const LPCWSTR *pLibNames,
+                              UINT32 libCount, const LPCWSTR *pArguments,
+                              UINT32 argCount, bool bAttachLibs,
+                              bool &bAttached,
+                              IDxcOperationResult **ppResult) {
   // Prepare UTF8-encoded versions of API values.
   CW2A pUtf8TargetProfile(pTargetProfile, CP_UTF8);
   CW2A pUtf8EntryPoint(pEntryName, CP_UTF8);
 
   CComPtr<AbstractMemoryStream> pOutputStream;
 
-  // Detach previous libraries.
-  m_pLinker->DetachAll();
-
   HRESULT hr = S_OK;
   try {
     CComPtr<IMalloc> pMalloc;
@@ -200,6 +315,10 @@ HRESULT STDMETHODCALLTYPE DxcLinker::Link(
                                  finished);
     if (pEntryName)
       opts.EntryPoint = pUtf8EntryPoint.m_psz;
+    if (pExports) {
+      CW2A pUtf8Exports(pExports, CP_UTF8);
+      opts.Exports.assign(1, pUtf8Exports.m_psz);
+    }
     if (finished) {
       return S_OK;
     }
@@ -228,16 +347,53 @@ HRESULT STDMETHODCALLTYPE DxcLinker::Link(
 
     // Attach libraries.
     bool bSuccess = true;
-    for (unsigned i = 0; i < libCount; i++) {
-      CW2A pUtf8LibName(pLibNames[i], CP_UTF8);
-      bSuccess &= m_pLinker->AttachLib(pUtf8LibName.m_psz);
+    if (bAttachLibs) {
+      // Detach previous libraries.
+      m_pLinker->DetachAll();
+      for (unsigned i = 0; i < libCount; i++) {
+        CW2A pUtf8LibName(pLibNames[i], CP_UTF8);
+        bSuccess &= m_pLinker->AttachLib(pUtf8LibName.m_psz);
+      }
+      bAttached = bSuccess;
     }
 
     dxilutil::ExportMap exportMap;
     bSuccess = exportMap.ParseExports(opts.Exports, DiagStream);
 
     bool hasErrorOccurred = !bSuccess;
-    if (bSuccess) {
+
+    // Outputs that link the same functions from the same libraries with the
+    // same arguments are identical, so reuse an earlier result if possible.
+    std::string linkKey;
+    CComPtr<IDxcBlob> pContainerToCache;
+    auto cacheIt = m_linkCache.end();
+    if (bSuccess && m_pLinker->GetLinkKey(opts.EntryPoint,
+                                          pUtf8TargetProfile.m_psz, exportMap,
+                                          linkKey)) {
+      for (UINT32 i = 0; i < argCount; i++) {
+        CW2A pUtf8Arg(pArguments[i], CP_UTF8);
+        linkKey += pUtf8Arg.m_psz;
+        linkKey += '\n';
+      }
+      for (const std::string &exports : opts.Exports) {
+        linkKey += exports;
+        linkKey += '\n';
+      }
+      cacheIt = m_linkCache.find(linkKey);
+    }
+
+    if (cacheIt != m_linkCache.end()) {
+      pOutputBlob = cacheIt->second.pContainer;
+      warnings = cacheIt->second.warnings;
+      CComPtr<IDxcBlob> pTargetBlob;
+      if (m_pDxcContainerEventsHandler != nullptr) {
+        HRESULT hr = m_pDxcContainerEventsHandler->OnDxilContainerBuilt(
+            pOutputBlob, &pTargetBlob);
+        if (SUCCEEDED(hr) && pTargetBlob != nullptr) {
+          std::swap(pOutputBlob, pTargetBlob);
+        }
+      }
+    } else if (bSuccess) {
       std::unique_ptr<Module> pM = m_pLinker->Link(
           opts.EntryPoint, pUtf8TargetProfile.m_psz, exportMap);
       if (pM) {
@@ -279,6 +435,8 @@ HRESULT STDMETHODCALLTYPE DxcLinker::Link(
         }
         // Callback after valid DXIL is produced
         if (SUCCEEDED(valHR)) {
+          if (!linkKey.empty())
+            pContainerToCache = pOutputBlob;
           CComPtr<IDxcBlob> pTargetBlob;
           if (m_pDxcContainerEventsHandler != nullptr) {
             HRESULT hr = m_pDxcContainerEventsHandler->OnDxilContainerBuilt(
@@ -297,6 +455,11 @@ HRESULT STDMETHODCALLTYPE DxcLinker::Link(
       }
     }
     DiagStream.flush();
+    if (pContainerToCache && !hasErrorOccurred) {
+      AddToLinkCache(linkKey, pContainerToCache,
+                     std::string((const char *)pDiagStream->GetPtr(),
+                                 pDiagStream->GetPtrSize()));
+    }
     CComPtr<IStream> pStream = pDiagStream;
     dxcutil::CreateOperationResultFromOutputs(pOutputBlob, pStream, warnings,
                                               hasErrorOccurred, ppResult);
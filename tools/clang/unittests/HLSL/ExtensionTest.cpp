@@ -449,6 +449,7 @@ public:
   TEST_METHOD(ReplicateLoweringWhenOnlyVectorIsResult)
   TEST_METHOD(UnsignedOpcodeIsUnchanged)
   TEST_METHOD(ResourceExtensionIntrinsic)
+  TEST_METHOD(ResourceExtensionIntrinsicQualifiedInNamespace)
   TEST_METHOD(NameLoweredWhenNoReplicationNeeded)
   TEST_METHOD(DxilLoweringVector1)
   TEST_METHOD(DxilLoweringVector2)
@@ -781,6 +782,26 @@ TEST_F(ExtensionTest, ResourceExtensionIntrinsic) {
   VERIFY_IS_TRUE(regex.match(disassembly));
 }
 
+TEST_F(ExtensionTest, ResourceExtensionIntrinsicQualifiedInNamespace) {
+  // Buffer is first named through a qualified lookup inside a namespace;
+  // the extension methods must still be added when it is declared.
+  Compiler c(m_dllSupport);
+  c.RegisterIntrinsicTable(new TestIntrinsicTable());
+  c.Compile(
+    "namespace N { ::Buffer<float2> buf; }"
+    "float2 main(uint2 v1 : V1) : SV_Target {\n"
+    "  return N::buf.MyBufferOp(uint2(1, 2));\n"
+    "}\n",
+    { L"/Vd" }, {}
+  );
+  std::string disassembly = c.Disassemble();
+
+  llvm::Regex regex("call %dx.types.ResRet.f32 @MyBufferOp\\(i32 12, %dx.types.Handle %.*, i32 1, i32 2\\)");
+  std::string regexErrors;
+  VERIFY_IS_TRUE(regex.isValid(regexErrors));
+  VERIFY_IS_TRUE(regex.match(disassembly));
+}
+
 TEST_F(ExtensionTest, NameLoweredWhenNoReplicationNeeded) {
   Compiler c(m_dllSupport);
   c.RegisterIntrinsicTable(new TestIntrinsicTable());
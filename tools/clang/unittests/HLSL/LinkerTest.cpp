@@ -14,6 +14,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "dxc/Test/CompilationResult.h"
 #include "dxc/Test/HLSLTestData.h"
+#include "dxc/DxilContainer/DxilContainer.h"
 #include "llvm/Support/ManagedStatic.h"
 
 #include <fstream>
@@ -40,6 +41,9 @@ public:
 
   TEST_METHOD(RunLinkResource);
   TEST_METHOD(RunLinkAllProfiles);
+  TEST_METHOD(RunLinkMultiple);
+  TEST_METHOD(RunLinkCachedResult);
+  TEST_METHOD(RunLinkFailCorruptProgramWithDebug);
   TEST_METHOD(RunLinkFailNoDefine);
   TEST_METHOD(RunLinkFailReDefine);
   TEST_METHOD(RunLinkGlobalInit);
@@ -188,6 +192,101 @@ TEST_F(LinkerTest, RunLinkAllProfiles) {
   Link(L"cs_main", L"cs_6_0", pLinker, {libName, libResName}, {},{});
 }
 
+TEST_F(LinkerTest, RunLinkMultiple) {
+  CComPtr<IDxcLinker> pLinker;
+  CreateLinker(&pLinker);
+  CComPtr<IDxcLinker2> pLinker2;
+  VERIFY_SUCCEEDED(pLinker.QueryInterface(&pLinker2));
+
+  LPCWSTR libName = L"entry";
+  CComPtr<IDxcBlob> pEntryLib;
+  CompileLib(L"..\\CodeGenHLSL\\lib_entries2.hlsl", &pEntryLib);
+  RegisterDxcModule(libName, pEntryLib, pLinker);
+
+  LPCWSTR entries[] = { L"vs_main", L"ps_main", L"missing", L"" };
+  LPCWSTR profiles[] = { L"vs_6_0", L"ps_6_0", L"ps_6_0", L"lib_6_3" };
+  LPCWSTR exports[] = { nullptr, nullptr, nullptr, L"ps_main" };
+  IDxcOperationResult *results[_countof(entries)];
+  VERIFY_SUCCEEDED(pLinker2->LinkMultiple(entries, profiles, exports,
+                                          _countof(entries), &libName, 1,
+                                          nullptr, 0, results));
+  CComPtr<IDxcOperationResult> pResults[_countof(entries)];
+  for (unsigned i = 0; i < _countof(entries); i++)
+    pResults[i].Attach(results[i]);
+
+  // A failing output must not affect the ones linked after it.
+  CComPtr<IDxcBlob> pProgram;
+  CheckOperationSucceeded(pResults[0], &pProgram);
+  pProgram.Release();
+  CheckOperationSucceeded(pResults[1], &pProgram);
+  pProgram.Release();
+  CheckOperationResultMsgs(pResults[2], {"Cannot find definition of function missing"},
+                           false, false);
+  CheckOperationSucceeded(pResults[3], &pProgram);
+}
+
+TEST_F(LinkerTest, RunLinkCachedResult) {
+  CComPtr<IDxcLinker> pLinker;
+  CreateLinker(&pLinker);
+
+  LPCWSTR libName = L"entry";
+  CComPtr<IDxcBlob> pEntryLib;
+  CompileLib(L"..\\CodeGenHLSL\\lib_entries2.hlsl", &pEntryLib);
+  RegisterDxcModule(libName, pEntryLib, pLinker);
+
+  LPCWSTR libResName = L"res";
+  CComPtr<IDxcBlob> pResLib;
+  CompileLib(L"..\\CodeGenHLSL\\lib_resource2.hlsl", &pResLib);
+  RegisterDxcModule(libResName, pResLib, pLinker);
+
+  // Attaching a lib that vs_main does not use must not change the result, so
+  // the second link returns the container cached by the first one.
+  LPCWSTR libNames[] = { libName, libResName };
+  LPCWSTR args[] = { L"-Zi" };
+  CComPtr<IDxcBlob> pPrograms[3];
+  for (unsigned i = 0; i < 3; i++) {
+    // The last link has different arguments and must not hit the cache.
+    UINT32 argCount = i == 2 ? 1 : 0;
+    CComPtr<IDxcOperationResult> pResult;
+    VERIFY_SUCCEEDED(pLinker->Link(L"vs_main", L"vs_6_0", libNames,
+                                   i == 0 ? 1 : 2, args, argCount, &pResult));
+    CheckOperationSucceeded(pResult, &pPrograms[i]);
+  }
+  VERIFY_ARE_EQUAL(pPrograms[0].p, pPrograms[1].p);
+  VERIFY_ARE_NOT_EQUAL(pPrograms[0].p, pPrograms[2].p);
+}
+
+TEST_F(LinkerTest, RunLinkFailCorruptProgramWithDebug) {
+  LPCWSTR option[] = { L"-Zi", L"-Qembed_debug" };
+  CComPtr<IDxcBlob> pEntryLib;
+  CompileLib(L"..\\CodeGenHLSL\\lib_entries2.hlsl", &pEntryLib, option);
+
+  // Corrupt only the program part; the debug part the linker loads stays valid.
+  std::vector<char> container(
+      (const char *)pEntryLib->GetBufferPointer(),
+      (const char *)pEntryLib->GetBufferPointer() + pEntryLib->GetBufferSize());
+  DxilContainerHeader *pHeader =
+      IsDxilContainerLike(container.data(), container.size());
+  VERIFY_IS_NOT_NULL(pHeader);
+  VERIFY_IS_NOT_NULL(
+      GetDxilPartByType(pHeader, DxilFourCC::DFCC_ShaderDebugInfoDXIL));
+  DxilPartHeader *pPart = GetDxilPartByType(pHeader, DxilFourCC::DFCC_DXIL);
+  VERIFY_IS_NOT_NULL(pPart);
+  DxilProgramHeader *pProgramHeader =
+      reinterpret_cast<DxilProgramHeader *>(GetDxilPartData(pPart));
+  pProgramHeader->BitcodeHeader.BitcodeSize = pPart->PartSize + 1;
+
+  CComPtr<IDxcLibrary> pLibrary;
+  VERIFY_SUCCEEDED(m_dllSupport.CreateInstance(CLSID_DxcLibrary, &pLibrary));
+  CComPtr<IDxcBlobEncoding> pCorruptLib;
+  VERIFY_SUCCEEDED(pLibrary->CreateBlobWithEncodingOnHeapCopy(
+      container.data(), container.size(), CP_ACP, &pCorruptLib));
+
+  CComPtr<IDxcLinker> pLinker;
+  CreateLinker(&pLinker);
+  VERIFY_FAILED(pLinker->RegisterLibrary(L"entry", pCorruptLib));
+}
+
 TEST_F(LinkerTest, RunLinkFailNoDefine) {
   CComPtr<IDxcBlob> pEntryLib;
   CompileLib(L"..\\CodeGenHLSL\\lib_cs_entry.hlsl", &pEntryLib);
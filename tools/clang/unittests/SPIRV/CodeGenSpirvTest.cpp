@@ -470,6 +470,7 @@ TEST_F(FileTest, CastSplatMatrix) { runFileTest("cast.matrix.splat.hlsl"); }
 TEST_F(FileTest, IfStmtPlainAssign) { runFileTest("cf.if.plain.hlsl"); }
 TEST_F(FileTest, IfStmtNestedIfStmt) { runFileTest("cf.if.nested.hlsl"); }
 TEST_F(FileTest, IfStmtConstCondition) { runFileTest("cf.if.const-cond.hlsl"); }
+TEST_F(FileTest, IfStmtLongChain) { runFileTest("cf.if.stress.hlsl"); }
 
 // For switch statements
 TEST_F(FileTest, SwitchStmtUsingOpSwitch) {
@@ -1423,6 +1424,22 @@ TEST_F(FileTest, SpirvOptOconfigInvalidFlag) {
   runFileTest("spirv.opt.invalid-flag.cl.oconfig.hlsl", Expect::Failure);
 }
 TEST_F(FileTest, SpirvOptOconfig) { runFileTest("spirv.opt.cl.oconfig.hlsl"); }
+// Test -fspv-time-report command line option.
+TEST_F(FileTest, SpirvTimeReport) {
+  runFileTest("spirv.cl.time-report.hlsl", Expect::Warning);
+}
+// Test -fspv-validation-cache command line option. Each file is compiled twice
+// so that the second compile can hit the cache.
+TEST_F(FileTest, SpirvValidationCache) {
+  setCompilerValidation();
+  runFileTest("spirv.cl.validation-cache.hlsl");
+  runFileTest("spirv.cl.validation-cache.hlsl");
+}
+TEST_F(FileTest, SpirvValidationCacheInvalidModule) {
+  setCompilerValidation();
+  runFileTest("spirv.cl.validation-cache.invalid.hlsl", Expect::Failure);
+  runFileTest("spirv.cl.validation-cache.invalid.hlsl", Expect::Failure);
+}
 
 // For shader stage input/output interface
 // For semantic SV_Position, SV_ClipDistance, SV_CullDistance
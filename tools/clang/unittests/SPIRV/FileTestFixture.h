@@ -29,7 +29,7 @@ public:
 
   FileTest()
       : targetEnv(SPV_ENV_VULKAN_1_0), beforeHLSLLegalization(false),
-        glLayout(false), dxLayout(false) {}
+        glLayout(false), dxLayout(false), compilerValidation(false) {}
 
   void useVulkan1p1() { targetEnv = SPV_ENV_VULKAN_1_1; }
   void useVulkan1p2() { targetEnv = SPV_ENV_VULKAN_1_2; }
@@ -37,6 +37,7 @@ public:
   void setGlLayout() { glLayout = true; }
   void setDxLayout() { dxLayout = true; }
   void setScalarLayout() { scalarLayout = true; }
+  void setCompilerValidation() { compilerValidation = true; }
 
   /// \brief Runs a File Test! (See class description for more info)
   void runFileTest(llvm::StringRef path, Expect expect = Expect::Success,
@@ -58,6 +59,7 @@ private:
   bool glLayout;
   bool dxLayout;
   bool scalarLayout;
+  bool compilerValidation; ///< Whether the compiler validates (no -Vd)
 };
 
 } // end namespace spirv
@@ -127,7 +127,8 @@ bool runCompilerWithSpirvGeneration(const llvm::StringRef inputFilePath,
                                     const llvm::StringRef targetProfile,
                                     const std::vector<std::string> &restArgs,
                                     std::vector<uint32_t> *generatedBinary,
-                                    std::string *errorMessages) {
+                                    std::string *errorMessages,
+                                    bool compilerValidation) {
   std::wstring srcFile(inputFilePath.begin(), inputFilePath.end());
   std::wstring entry(entryPoint.begin(), entryPoint.end());
   std::wstring profile(targetProfile.begin(), targetProfile.end());
@@ -172,8 +173,10 @@ bool runCompilerWithSpirvGeneration(const llvm::StringRef inputFilePath,
     // wants to run a specific optimization recipe (with -Oconfig).
     if (!requires_opt)
       flags.push_back(L"-fcgl");
-    // Disable validation. We'll run it manually.
-    flags.push_back(L"-Vd");
+    // Disable validation. We'll run it manually, unless the caller tests the
+    // compiler's own validation.
+    if (!compilerValidation)
+      flags.push_back(L"-Vd");
     for (const auto &arg : rest)
       flags.push_back(arg.c_str());
 
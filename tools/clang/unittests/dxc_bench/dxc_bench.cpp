@@ -0,0 +1,639 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// dxc_bench.cpp                                                             //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+// Provides the entry point for the dxc_bench console program.               //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+// dxc_bench compiles a pinned corpus of shaders in-process through
+// IDxcCompiler3 and reports compile time, peak compiler heap usage and
+// output size per file and configuration. Results can be saved as a baseline
+// and later runs compared against it, failing on regressions.
+//
+// Corpus files list one compile per line:
+//   <kind> <path> <dxc arguments...>
+// where <kind> is 'dxil', 'spirv' or 'all' and selects the configurations
+// the line takes part in, and <path> is relative to the corpus file.
+// Empty lines and lines starting with '#' are ignored.
+//
+// -spirv-tests adds every test of a SPIR-V CodeGen test directory, compiled
+// with the arguments of its '// Run: %dxc' line, the same way the SPIR-V
+// FileTest fixture finds them. A test that fails to compile is skipped only if
+// one of its CHECK lines expects an error or it is pinned as an expected
+// failure; any other failure is reported.
+//
+// -phases compiles the SPIR-V configuration with -fspv-time-report and also
+// reports the time spent in each code generation phase, under the
+// configuration name 'spirv:<phase>'. 'spirv:front end' is whatever the
+// phases do not account for: parsing, Sema and compiler setup.
+
+#include "dxc/Support/Global.h"
+#include "dxc/Support/Unicode.h"
+#include "dxc/Support/WinIncludes.h"
+#include "dxc/Support/dxcapi.use.h"
+#include "dxc/Support/microcom.h"
+#include "dxc/dxcapi.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace dxc;
+using namespace llvm;
+
+static cl::opt<std::string> CorpusFile(cl::Positional,
+                                       cl::desc("<corpus file>"),
+                                       cl::Required);
+
+static cl::opt<std::string>
+    Configs("configs", cl::desc("Comma-separated configurations to run "
+                                "(Od, O3, spirv, fcgl)"),
+            cl::init("Od,O3,spirv"));
+
+static cl::opt<unsigned>
+    Iterations("iterations",
+               cl::desc("Compiles per file; the fastest one is reported"),
+               cl::init(3));
+
+static cl::opt<std::string>
+    SaveFile("save", cl::desc("Write results to the given baseline file"));
+
+static cl::opt<std::string>
+    BaselineFile("baseline", cl::desc("Compare results against a baseline"));
+
+static cl::opt<double> Threshold(
+    "threshold",
+    cl::desc("Allowed slowdown or growth over the baseline, in percent"),
+    cl::init(10.0));
+
+static cl::opt<double> MinTimeMs(
+    "min-time",
+    cl::desc("Ignore time regressions for files faster than this many ms"),
+    cl::init(5.0));
+
+static cl::opt<std::string>
+    SpirvTestDir("spirv-tests",
+                 cl::desc("Also compile every test in the given SPIR-V "
+                          "CodeGen test directory"));
+
+static cl::opt<bool>
+    Phases("phases",
+           cl::desc("Report the time of each SPIR-V code generation phase"));
+
+static cl::opt<std::string>
+    JsonFile("json", cl::desc("Write results to the given file as JSON"));
+
+namespace {
+
+// Forwards to the CRT heap and records the high-water mark of live bytes.
+// Every block carries a header with its size so Free can account for it.
+struct PeakTrackingMalloc : public IMalloc {
+private:
+  union Header {
+    SIZE_T Size;
+    std::max_align_t Align;
+  };
+  SIZE_T m_Current = 0;
+  SIZE_T m_Peak = 0;
+
+public:
+  // Starts a new measurement; returns the bytes live at this point.
+  SIZE_T ResetPeak() { return m_Peak = m_Current; }
+  SIZE_T GetPeak() const { return m_Peak; }
+
+  ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+  ULONG STDMETHODCALLTYPE Release() override { return 1; }
+  STDMETHODIMP QueryInterface(REFIID iid, void **ppvObject) override {
+    return DoBasicQueryInterface<IMalloc>(this, iid, ppvObject);
+  }
+  void *STDMETHODCALLTYPE Alloc(_In_ SIZE_T cb) override {
+    Header *H = (Header *)malloc(sizeof(Header) + cb);
+    if (H == nullptr)
+      return nullptr;
+    H->Size = cb;
+    m_Current += cb;
+    m_Peak = std::max(m_Peak, m_Current);
+    return H + 1;
+  }
+  void *STDMETHODCALLTYPE Realloc(_In_opt_ void *pv, _In_ SIZE_T cb) override {
+    if (pv == nullptr)
+      return Alloc(cb);
+    Header *H = ((Header *)pv) - 1;
+    SIZE_T OldSize = H->Size;
+    H = (Header *)realloc(H, sizeof(Header) + cb);
+    if (H == nullptr)
+      return nullptr;
+    H->Size = cb;
+    m_Current = m_Current - OldSize + cb;
+    m_Peak = std::max(m_Peak, m_Current);
+    return H + 1;
+  }
+  void STDMETHODCALLTYPE Free(_In_opt_ void *pv) override {
+    if (pv == nullptr)
+      return;
+    Header *H = ((Header *)pv) - 1;
+    m_Current -= H->Size;
+    free(H);
+  }
+  SIZE_T STDMETHODCALLTYPE GetSize(_In_opt_ void *pv) override {
+    return pv == nullptr ? 0 : (((Header *)pv) - 1)->Size;
+  }
+  int STDMETHODCALLTYPE DidAlloc(_In_opt_ void *pv) override { return -1; }
+  void STDMETHODCALLTYPE HeapMinimize() override {}
+};
+
+struct CorpusEntry {
+  std::string Kind;
+  std::string Path;
+  std::vector<std::string> Args;
+  bool SkipOnFailure = false; // The compile is expected to fail.
+};
+
+struct BenchResult {
+  double TimeMs = 0;
+  uint64_t PeakBytes = 0;
+  uint64_t OutputBytes = 0;
+  bool Succeeded = false;
+  // Milliseconds per code generation phase, with -phases.
+  std::map<std::string, double> PhaseMs;
+};
+
+// Results keyed by "config<TAB>path".
+typedef std::map<std::string, BenchResult> ResultMap;
+
+struct BenchConfig {
+  const char *Name;
+  const char *Kind;
+  std::vector<const char *> Args;
+};
+
+const BenchConfig g_Configs[] = {
+  { "Od", "dxil", { "-Od" } },
+  { "O3", "dxil", { "-O3" } },
+  { "spirv", "spirv", { "-spirv" } },
+  // Front end only: parsing, Sema and high-level codegen, no optimization.
+  { "fcgl", "dxil", { "-fcgl" } },
+};
+
+} // namespace
+
+static bool ReadCorpus(StringRef Path, std::vector<CorpusEntry> &Entries) {
+  std::ifstream In(Path.str());
+  if (!In) {
+    errs() << "dxc_bench: cannot open corpus file '" << Path << "'\n";
+    return false;
+  }
+  SmallString<128> Dir(Path);
+  sys::path::remove_filename(Dir);
+  std::string Line;
+  while (std::getline(In, Line)) {
+    std::istringstream LineStream(Line);
+    CorpusEntry Entry;
+    if (!(LineStream >> Entry.Kind) || Entry.Kind[0] == '#')
+      continue;
+    std::string RelPath;
+    if (!(LineStream >> RelPath)) {
+      errs() << "dxc_bench: missing path in corpus line '" << Line << "'\n";
+      return false;
+    }
+    SmallString<128> FullPath(Dir);
+    sys::path::append(FullPath, RelPath);
+    Entry.Path = FullPath.str();
+    std::string Arg;
+    while (LineStream >> Arg)
+      Entry.Args.push_back(Arg);
+    Entries.push_back(std::move(Entry));
+  }
+  return true;
+}
+
+// SPIR-V tests that are expected to fail to compile although no CHECK line
+// includes an "error:" prefix.
+static const char *g_SpirvExpectedFailures[] = {
+  "spirv.debug.ctrl.unknown.hlsl",
+  "spirv.opt.invalid-flag.cl.oconfig.hlsl",
+  "spirv.opt.multiple.cl.oconfig.hlsl",
+  "spirv.opt.with-O0.cl.oconfig.hlsl",
+  "spirv.opt.with-O1.cl.oconfig.hlsl",
+  "spirv.opt.with-O2.cl.oconfig.hlsl",
+  "spirv.opt.with-O3.cl.oconfig.hlsl",
+};
+
+// Adds the tests in Dir whose first line is a '// Run: %dxc <args>' command.
+static bool ReadSpirvTests(StringRef Dir, std::vector<CorpusEntry> &Entries) {
+  std::error_code EC;
+  std::vector<std::string> Paths;
+  for (sys::fs::directory_iterator It(Dir, EC), End; It != End && !EC;
+       It.increment(EC))
+    if (sys::path::extension(It->path()) == ".hlsl")
+      Paths.push_back(It->path());
+  if (EC) {
+    errs() << "dxc_bench: cannot read test directory '" << Dir
+           << "': " << EC.message() << "\n";
+    return false;
+  }
+  std::sort(Paths.begin(), Paths.end());
+
+  for (const std::string &Path : Paths) {
+    std::ifstream In(Path);
+    std::string Line;
+    if (!std::getline(In, Line))
+      continue;
+    std::istringstream LineStream(Line);
+    std::string Comment, Run, Dxc;
+    if (!(LineStream >> Comment >> Run >> Dxc) || Comment != "//" ||
+        Run != "Run:" || Dxc != "%dxc")
+      continue;
+    CorpusEntry Entry;
+    Entry.Kind = "spirv";
+    Entry.Path = Path;
+    std::string Arg;
+    while (LineStream >> Arg)
+      Entry.Args.push_back(Arg);
+    // Pinned tests and tests checking error messages are meant to fail to
+    // compile.
+    for (const char *Name : g_SpirvExpectedFailures)
+      if (sys::path::filename(Path) == Name)
+        Entry.SkipOnFailure = true;
+    while (!Entry.SkipOnFailure && std::getline(In, Line)) {
+      size_t CheckPos = Line.find("CHECK");
+      if (Line.compare(0, 2, "//") == 0 && CheckPos != std::string::npos &&
+          Line.find("error:", CheckPos) != std::string::npos) {
+        Entry.SkipOnFailure = true;
+        break;
+      }
+    }
+    Entries.push_back(std::move(Entry));
+  }
+  return true;
+}
+
+// Adds the wall times in the timer reports of Text to Phases, by timer name.
+// A report is a table headed by a '--- Name ---' line, with one row per timer
+// whose last '<seconds> (<percent>%)' column is the wall time, and a final
+// 'Total' row.
+static void ParseTimeReport(StringRef Text,
+                            std::map<std::string, double> &Phases) {
+  SmallVector<StringRef, 32> Lines;
+  Text.split(Lines, "\n", -1, false);
+  bool InTable = false;
+  for (StringRef Line : Lines) {
+    Line = Line.rtrim("\r");
+    if (Line.find("--- Name ---") != StringRef::npos) {
+      InTable = true;
+      continue;
+    }
+    size_t NamePos = Line.rfind("%)");
+    if (!InTable || NamePos == StringRef::npos)
+      continue;
+    StringRef Name = Line.substr(NamePos + 2).trim();
+    if (Name == "Total") {
+      InTable = false;
+      continue;
+    }
+    StringRef Wall = Line.substr(0, Line.rfind('(', NamePos)).rtrim();
+    Wall = Wall.substr(Wall.rfind(' ') + 1);
+    Phases[Name] += strtod(Wall.str().c_str(), nullptr) * 1000.0;
+  }
+}
+
+static bool ReadFileContents(StringRef Path, std::string &Contents) {
+  std::ifstream In(Path.str(), std::ios::binary);
+  if (!In)
+    return false;
+  std::ostringstream Stream;
+  Stream << In.rdbuf();
+  Contents = Stream.str();
+  return true;
+}
+
+static BenchResult CompileOnce(DxcDllSupport &Support,
+                               PeakTrackingMalloc &Malloc,
+                               const std::string &Source,
+                               const std::vector<std::wstring> &Args,
+                               std::string &Errors) {
+  BenchResult Result;
+  std::vector<LPCWSTR> ArgPtrs;
+  for (const std::wstring &Arg : Args)
+    ArgPtrs.push_back(Arg.c_str());
+
+  SIZE_T StartBytes = Malloc.ResetPeak();
+  auto Start = std::chrono::steady_clock::now();
+  {
+    CComPtr<IDxcCompiler3> pCompiler;
+    CComPtr<IDxcUtils> pUtils;
+    CComPtr<IDxcIncludeHandler> pIncludeHandler;
+    CComPtr<IDxcResult> pResult;
+    IFT(Support.CreateInstance2(&Malloc, CLSID_DxcCompiler, &pCompiler));
+    IFT(Support.CreateInstance2(&Malloc, CLSID_DxcUtils, &pUtils));
+    IFT(pUtils->CreateDefaultIncludeHandler(&pIncludeHandler));
+    DxcBuffer Buffer = { Source.data(), Source.size(), DXC_CP_ACP };
+    IFT(pCompiler->Compile(&Buffer, ArgPtrs.data(), (UINT32)ArgPtrs.size(),
+                           pIncludeHandler, IID_PPV_ARGS(&pResult)));
+    HRESULT Status;
+    IFT(pResult->GetStatus(&Status));
+    Result.Succeeded = SUCCEEDED(Status);
+    if (Result.Succeeded) {
+      CComPtr<IDxcBlob> pObject;
+      IFT(pResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&pObject), nullptr));
+      if (pObject)
+        Result.OutputBytes = pObject->GetBufferSize();
+    }
+    // Failures report their diagnostics here; timer reports are printed to
+    // stderr, which ends up here as well.
+    CComPtr<IDxcBlobUtf8> pErrors;
+    IFT(pResult->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&pErrors), nullptr));
+    if (pErrors)
+      Errors.assign(pErrors->GetStringPointer(), pErrors->GetStringLength());
+  }
+  auto End = std::chrono::steady_clock::now();
+  Result.TimeMs = std::chrono::duration<double, std::milli>(End - Start).count();
+  Result.PeakBytes = Malloc.GetPeak() - StartBytes;
+  if (Result.Succeeded && Phases) {
+    ParseTimeReport(Errors, Result.PhaseMs);
+    double Accounted = 0;
+    for (const auto &Phase : Result.PhaseMs)
+      Accounted += Phase.second;
+    if (!Result.PhaseMs.empty())
+      Result.PhaseMs["front end"] = std::max(0.0, Result.TimeMs - Accounted);
+  }
+  return Result;
+}
+
+static bool RunCorpus(DxcDllSupport &Support,
+                      const std::vector<CorpusEntry> &Entries,
+                      ResultMap &Results) {
+  SmallVector<StringRef, 4> ConfigNames;
+  StringRef(Configs).split(ConfigNames, ",", -1, false);
+  PeakTrackingMalloc Malloc;
+  bool AllSucceeded = true;
+  unsigned Skipped = 0;
+
+  outs() << format("%-6s %10s %12s %10s  %s\n", "config", "time(ms)",
+                   "peak(KB)", "size(B)", "file");
+  for (StringRef ConfigName : ConfigNames) {
+    const BenchConfig *Config = nullptr;
+    for (const BenchConfig &C : g_Configs)
+      if (ConfigName.equals_lower(C.Name))
+        Config = &C;
+    if (!Config) {
+      errs() << "dxc_bench: unknown configuration '" << ConfigName << "'\n";
+      return false;
+    }
+
+    BenchResult Total;
+    for (const CorpusEntry &Entry : Entries) {
+      if (Entry.Kind != "all" && Entry.Kind != Config->Kind)
+        continue;
+      std::string Source;
+      if (!ReadFileContents(Entry.Path, Source)) {
+        errs() << "dxc_bench: cannot read '" << Entry.Path << "'\n";
+        AllSucceeded = false;
+        continue;
+      }
+
+      std::vector<std::wstring> Args;
+      Args.push_back(Unicode::UTF8ToUTF16StringOrThrow(Entry.Path.c_str()));
+      for (const std::string &Arg : Entry.Args)
+        Args.push_back(Unicode::UTF8ToUTF16StringOrThrow(Arg.c_str()));
+      for (const char *Arg : Config->Args)
+        Args.push_back(Unicode::UTF8ToUTF16StringOrThrow(Arg));
+      if (Phases && StringRef(Config->Kind) == "spirv")
+        Args.push_back(L"-fspv-time-report");
+
+      BenchResult Best;
+      std::string Errors;
+      for (unsigned i = 0; i < std::max(1u, (unsigned)Iterations); ++i) {
+        BenchResult R = CompileOnce(Support, Malloc, Source, Args, Errors);
+        if (!R.Succeeded) {
+          Best = R;
+          break;
+        }
+        if (i == 0 || R.TimeMs < Best.TimeMs)
+          Best = R;
+      }
+      if (!Best.Succeeded && Entry.SkipOnFailure) {
+        ++Skipped;
+        continue;
+      }
+      if (!Best.Succeeded) {
+        errs() << "dxc_bench: " << Config->Name << " compile failed for '"
+               << Entry.Path << "'\n" << Errors << "\n";
+        AllSucceeded = false;
+        continue;
+      }
+
+      outs() << format("%-6s %10.2f %12llu %10llu  %s\n", Config->Name,
+                       Best.TimeMs, (unsigned long long)(Best.PeakBytes / 1024),
+                       (unsigned long long)Best.OutputBytes,
+                       Entry.Path.c_str());
+      Results[std::string(Config->Name) + "\t" + Entry.Path] = Best;
+      for (const auto &Phase : Best.PhaseMs) {
+        BenchResult PhaseResult;
+        PhaseResult.TimeMs = Phase.second;
+        PhaseResult.Succeeded = true;
+        Results[std::string(Config->Name) + ":" + Phase.first + "\t" +
+                Entry.Path] = PhaseResult;
+        outs() << format("%-6s %10.2f %12s %10s    %s\n", "", Phase.second,
+                         "", "", Phase.first.c_str());
+      }
+      Total.TimeMs += Best.TimeMs;
+      Total.PeakBytes = std::max(Total.PeakBytes, Best.PeakBytes);
+      Total.OutputBytes += Best.OutputBytes;
+    }
+    outs() << format("%-6s %10.2f %12llu %10llu  <total>\n", Config->Name,
+                     Total.TimeMs,
+                     (unsigned long long)(Total.PeakBytes / 1024),
+                     (unsigned long long)Total.OutputBytes);
+  }
+  if (Skipped)
+    outs() << Skipped << " test(s) skipped because they do not compile\n";
+  return AllSucceeded;
+}
+
+static bool SaveResults(StringRef Path, const ResultMap &Results) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::F_Text);
+  if (EC) {
+    errs() << "dxc_bench: cannot write '" << Path << "': " << EC.message()
+           << "\n";
+    return false;
+  }
+  OS << "# config\tfile\ttime_ms\tpeak_bytes\toutput_bytes\n";
+  for (const auto &It : Results)
+    OS << It.first << "\t" << format("%.3f", It.second.TimeMs) << "\t"
+       << It.second.PeakBytes << "\t" << It.second.OutputBytes << "\n";
+  return true;
+}
+
+static void WriteJsonString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  for (char C : Str) {
+    if (C == '"' || C == '\\')
+      OS << '\\' << C;
+    else if ((unsigned char)C < 0x20)
+      OS << format("\\u%04x", (unsigned)C);
+    else
+      OS << C;
+  }
+  OS << '"';
+}
+
+// Writes one object per result, splitting 'config:phase' keys so that phase
+// timings can be grouped with the compile they belong to.
+static bool SaveJsonResults(StringRef Path, const ResultMap &Results) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::F_Text);
+  if (EC) {
+    errs() << "dxc_bench: cannot write '" << Path << "': " << EC.message()
+           << "\n";
+    return false;
+  }
+  OS << "[";
+  bool First = true;
+  for (const auto &It : Results) {
+    StringRef Config, File, Phase;
+    std::tie(Config, File) = StringRef(It.first).split('\t');
+    std::tie(Config, Phase) = Config.split(':');
+    OS << (First ? "\n" : ",\n") << "  {\"config\": ";
+    WriteJsonString(OS, Config);
+    OS << ", \"phase\": ";
+    WriteJsonString(OS, Phase);
+    OS << ", \"file\": ";
+    WriteJsonString(OS, File);
+    OS << format(", \"time_ms\": %.3f", It.second.TimeMs)
+       << ", \"peak_bytes\": " << It.second.PeakBytes
+       << ", \"output_bytes\": " << It.second.OutputBytes << "}";
+    First = false;
+  }
+  OS << "\n]\n";
+  return true;
+}
+
+static bool LoadResults(StringRef Path, ResultMap &Results) {
+  std::ifstream In(Path.str());
+  if (!In) {
+    errs() << "dxc_bench: cannot open baseline '" << Path << "'\n";
+    return false;
+  }
+  std::string Line;
+  while (std::getline(In, Line)) {
+    if (Line.empty() || Line[0] == '#')
+      continue;
+    SmallVector<StringRef, 5> Fields;
+    StringRef(Line).split(Fields, "\t");
+    if (Fields.size() != 5)
+      continue;
+    BenchResult R;
+    R.TimeMs = strtod(Fields[2].str().c_str(), nullptr);
+    Fields[3].getAsInteger(10, R.PeakBytes);
+    Fields[4].getAsInteger(10, R.OutputBytes);
+    R.Succeeded = true;
+    Results[(Fields[0] + "\t" + Fields[1]).str()] = R;
+  }
+  return true;
+}
+
+// Returns the number of regressions beyond the threshold.
+static unsigned CompareResults(const ResultMap &Baseline,
+                               const ResultMap &Results) {
+  unsigned Regressions = 0;
+  double Limit = 1.0 + Threshold / 100.0;
+  for (const auto &It : Results) {
+    auto BaseIt = Baseline.find(It.first);
+    if (BaseIt == Baseline.end())
+      continue;
+    const BenchResult &Base = BaseIt->second;
+    const BenchResult &Cur = It.second;
+    auto Report = [&](const char *What, double Old, double New) {
+      outs() << "REGRESSION: " << It.first << ": " << What << " "
+             << format("%.2f -> %.2f (%+.1f%%)", Old, New,
+                       (New / Old - 1.0) * 100.0)
+             << "\n";
+      ++Regressions;
+    };
+    if (Cur.TimeMs > MinTimeMs && Cur.TimeMs > Base.TimeMs * Limit)
+      Report("time(ms)", Base.TimeMs, Cur.TimeMs);
+    if (Base.PeakBytes && Cur.PeakBytes > Base.PeakBytes * Limit)
+      Report("peak(KB)", Base.PeakBytes / 1024.0, Cur.PeakBytes / 1024.0);
+  }
+  return Regressions;
+}
+
+int main(int argc, const char **argv) {
+  const char *pStage = "Initialization";
+  if (FAILED(DxcInitThreadMalloc()))
+    return 1;
+  DxcSetThreadMallocToDefault();
+  if (llvm::sys::fs::SetupPerThreadFileSystem())
+    return 1;
+  llvm::sys::fs::AutoCleanupPerThreadFileSystem auto_cleanup_fs;
+  int retVal = 0;
+  try {
+    pStage = "Argument processing";
+    cl::ParseCommandLineOptions(argc, argv, "DXC compile-time benchmark\n");
+
+    pStage = "Corpus loading";
+    std::vector<CorpusEntry> Entries;
+    if (!ReadCorpus(CorpusFile, Entries))
+      return 1;
+    if (!SpirvTestDir.empty() && !ReadSpirvTests(SpirvTestDir, Entries))
+      return 1;
+
+    ResultMap Baseline;
+    if (!BaselineFile.empty() && !LoadResults(BaselineFile, Baseline))
+      return 1;
+
+    DxcDllSupport dxcSupport;
+    IFT(dxcSupport.Initialize());
+
+    pStage = "Compilation";
+    ResultMap Results;
+    if (!RunCorpus(dxcSupport, Entries, Results))
+      retVal = 1;
+
+    if (!SaveFile.empty() && !SaveResults(SaveFile, Results))
+      retVal = 1;
+
+    if (!JsonFile.empty() && !SaveJsonResults(JsonFile, Results))
+      retVal = 1;
+
+    if (!BaselineFile.empty()) {
+      unsigned Regressions = CompareResults(Baseline, Results);
+      outs() << Regressions << " regression(s) over " << Threshold
+             << "% against '" << BaselineFile << "'\n";
+      if (Regressions)
+        retVal = 1;
+    }
+  } catch (const ::hlsl::Exception &hlslException) {
+    fprintf(stderr, "%s failed - %s (0x%08x).\n", pStage, hlslException.what(),
+            (unsigned)hlslException.hr);
+    retVal = 1;
+  } catch (std::bad_alloc &) {
+    fprintf(stderr, "%s failed - out of memory.\n", pStage);
+    retVal = 1;
+  } catch (...) {
+    fprintf(stderr, "%s failed - unknown error.\n", pStage);
+    retVal = 1;
+  }
+  DxcCleanupThreadMalloc();
+  return retVal;
+}
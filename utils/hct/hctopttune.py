@@ -0,0 +1,323 @@
+# Copyright (C) Microsoft Corporation. All rights reserved.
+# This file is distributed under the University of Illinois Open Source License. See LICENSE.TXT for details.
+#
+# hctopttune.py - searches for a per-shader optimization pipeline.
+#
+# Starting from the pipeline that dxc uses for the shader (dxc -Odump), this
+# script mutates the order, repetition and arguments of the standard LLVM
+# optimization passes, runs each candidate through dxopt on the shader's
+# high-level module (dxc -fcgl) and scores the result. HLSL lowering passes
+# are never moved or removed, so every candidate stays within the legal HLSL
+# pipeline. The best pipeline is written as a dxopt pass file, which can be
+# pinned for a shader family with 'dxopt -pf <file>'. Run with --self-test
+# alone to check the module parser.
+#
+# Objectives:
+#   inst-count  number of instructions in the optimized module
+#   pressure    number of SSA values live across basic blocks (register
+#               pressure proxy)
+#   cycles      static cycle estimate from a per-opcode cost table (JSON
+#               object mapping an LLVM opcode or DXIL operation class such as
+#               'dx.op.sample' to a cost; anything missing costs 1)
+import argparse
+import concurrent.futures
+import json
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Passes the search may drop, repeat, swap or re-parameterize. Everything
+# else in the -Odump output is treated as a fixed part of the HLSL pipeline.
+tunable_passes = set([
+    "adce", "bdce", "constmerge", "correlated-propagation", "dse",
+    "early-cse", "globalopt", "gvn", "indvars", "instcombine", "ipsccp",
+    "jump-threading", "licm", "loop-deletion", "loop-idiom", "loop-rotate",
+    "loop-unroll", "loop-unswitch", "memcpyopt", "mldst-motion", "reassociate",
+    "sccp", "simplifycfg", "sink", "tailcallelim",
+])
+
+# Numeric pass arguments the search may change, with candidate values.
+tunable_args = {
+    "loop-unroll": {"unroll-threshold": [50, 150, 300, 600, 1200]},
+    "jump-threading": {"jump-threading-threshold": [3, 6, 12]},
+    "loop-unswitch": {"loop-unswitch-threshold": [50, 100, 200]},
+    "gvn": {"max-recurse-depth": [500, 1000, 2000]},
+}
+
+# Mutations tried per requested candidate before a generation gives up on
+# finding new pipelines.
+mutation_attempts = 20
+
+class Pass(object):
+    def __init__(self, line):
+        self.line = line.strip()
+        self.name = self.line[1:].split(",")[0] if self.line.startswith("-") else ""
+
+    def is_tunable(self):
+        return self.name in tunable_passes
+
+    def with_arg(self, arg, value):
+        parts = [p for p in self.line.split(",") if not p.startswith(arg + "=")]
+        return Pass(",".join(parts + ["%s=%s" % (arg, value)]))
+
+def run(cmd, cwd=None):
+    proc = subprocess.Popen(cmd, cwd=cwd, stdout=subprocess.PIPE,
+                            stderr=subprocess.PIPE, universal_newlines=True)
+    out, err = proc.communicate()
+    return proc.returncode, out, err
+
+def get_base_pipeline(args):
+    code, out, err = run([args.dxc, "-Odump", "-E", args.entry, "-T", args.target] +
+                         args.dxc_args + [args.shader])
+    if code != 0:
+        raise RuntimeError("dxc -Odump failed:\n" + err)
+    return [Pass(l) for l in out.splitlines() if l.strip()]
+
+def get_hl_module(args, workdir):
+    hl_path = os.path.join(workdir, "shader.hl.ll")
+    code, out, err = run([args.dxc, "-fcgl", "-E", args.entry, "-T", args.target] +
+                         args.dxc_args + ["-Fc", hl_path, args.shader])
+    if code != 0:
+        raise RuntimeError("dxc -fcgl failed:\n" + err)
+    return hl_path
+
+def mutate(pipeline, rng):
+    result = list(pipeline)
+    tunable = [i for i, p in enumerate(result) if p.is_tunable()]
+    if not tunable:
+        return result
+    i = rng.choice(tunable)
+    kind = rng.choice(["drop", "repeat", "swap", "arg"])
+    if kind == "drop":
+        del result[i]
+    elif kind == "repeat":
+        result.insert(i + 1, result[i])
+    elif kind == "swap":
+        # Only swap with an adjacent tunable pass so that fixed passes keep
+        # their position relative to everything else.
+        if i + 1 < len(result) and result[i + 1].is_tunable():
+            result[i], result[i + 1] = result[i + 1], result[i]
+    else:
+        choices = tunable_args.get(result[i].name)
+        if choices:
+            arg = rng.choice(sorted(choices.keys()))
+            result[i] = result[i].with_arg(arg, rng.choice(choices[arg]))
+    return result
+
+def pipeline_key(pipeline):
+    return "\n".join(p.line for p in pipeline)
+
+def parse_functions(text):
+    # Yields (blocks) per defined function, where blocks is a list of lists of
+    # instruction lines.
+    in_function = False
+    blocks = []
+    for line in text.splitlines():
+        stripped = line.strip()
+        if stripped.startswith("define "):
+            in_function = True
+            blocks = [[]]
+            continue
+        if not in_function:
+            continue
+        if stripped == "}":
+            in_function = False
+            yield blocks
+            continue
+        # LLVM 3.7 prints unnamed blocks as a '; <label>:N' comment.
+        if re.match(r"^[\w.$-]+:", stripped) or re.match(r"^; <label>:\d+", stripped):
+            blocks.append([])
+            continue
+        if not stripped or stripped.startswith(";"):
+            continue
+        blocks[-1].append(stripped)
+
+def self_test():
+    # Checks block splitting on a module with named and unnamed blocks.
+    text = """define void @main() {
+entry:
+  %0 = add i32 1, 2
+  br i1 true, label %1, label %2
+
+; <label>:1                                       ; preds = %entry
+  %3 = add i32 %0, 1
+  br label %2
+
+; <label>:2                                       ; preds = %1, %entry
+  ret void
+}
+"""
+    blocks = list(parse_functions(text))
+    assert [len(b) for b in blocks[0]] == [0, 2, 2, 1], blocks
+    assert score_module(text, "pressure", {}) == 1
+    print("self-test passed")
+    return 0
+
+def instruction_opcode(inst):
+    body = inst.split("=", 1)[1].strip() if re.match(r"^%[\w.$-]+\s*=", inst) else inst
+    call = re.search(r"@(dx\.op\.\w+)", body)
+    if body.startswith(("call", "tail call")) and call:
+        return call.group(1)
+    return body.split(" ", 1)[0]
+
+def score_module(text, objective, costs):
+    total = 0
+    for blocks in parse_functions(text):
+        if objective == "inst-count":
+            total += sum(len(b) for b in blocks)
+        elif objective == "cycles":
+            for b in blocks:
+                for inst in b:
+                    total += costs.get(instruction_opcode(inst), 1)
+        else:
+            def_block = {}
+            for bi, b in enumerate(blocks):
+                for inst in b:
+                    m = re.match(r"^(%[\w.$-]+)\s*=", inst)
+                    if m:
+                        def_block[m.group(1)] = bi
+            live = set()
+            for bi, b in enumerate(blocks):
+                for inst in b:
+                    for name in re.findall(r"%[\w.$-]+", inst):
+                        if def_block.get(name, bi) != bi:
+                            live.add(name)
+            total += len(live)
+    return total
+
+def evaluate(args, hl_path, pipeline, costs, index):
+    # With -S, dxopt prints the optimized module to its standard output.
+    passes_path = os.path.join(args.workdir, "cand%d.passes.txt" % index)
+    with open(passes_path, "w") as f:
+        f.write(pipeline_key(pipeline) + "\n-S\n")
+    code, out, err = run([args.dxopt, "-pf", passes_path, hl_path])
+    if code != 0:
+        return None
+    return score_module(out, args.objective, costs)
+
+def validate(args, pipeline):
+    # Rebuilds the winning module into a container and runs the validator.
+    passes_path = os.path.join(args.workdir, "best.passes.txt")
+    ll_path = os.path.join(args.workdir, "best.ll")
+    cso_path = os.path.join(args.workdir, "best.cso")
+    with open(passes_path, "w") as f:
+        f.write(pipeline_key(pipeline) + "\n-S\n")
+    hl_path = os.path.join(args.workdir, "shader.hl.ll")
+    code, out, err = run([args.dxopt, "-pf", passes_path, hl_path])
+    if code != 0:
+        return False
+    with open(ll_path, "w") as f:
+        f.write(out)
+    for cmd in ([args.dxa, ll_path, "-o", cso_path], [args.dxv, cso_path]):
+        code, out, err = run(cmd)
+        if code != 0:
+            return False
+    return True
+
+def search(args):
+    rng = random.Random(args.seed)
+    costs = {}
+    if args.cost_table:
+        with open(args.cost_table) as f:
+            costs = json.load(f)
+
+    base = get_base_pipeline(args)
+    hl_path = get_hl_module(args, args.workdir)
+    base_score = evaluate(args, hl_path, base, costs, 0)
+    if base_score is None:
+        raise RuntimeError("dxopt failed on the default pipeline")
+    print("default pipeline: %s = %d" % (args.objective, base_score))
+
+    scored = {pipeline_key(base): (base_score, base)}
+    population = [base]
+    index = 1
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        for generation in range(args.generations):
+            # Mutations can keep producing pipelines that were already scored,
+            # or none at all when there is nothing to tune, so the number of
+            # attempts is bounded.
+            candidates = []
+            seen = set()
+            for attempt in range(args.population * mutation_attempts):
+                if len(candidates) >= args.population:
+                    break
+                cand = mutate(rng.choice(population), rng)
+                if rng.random() < 0.5:
+                    cand = mutate(cand, rng)
+                key = pipeline_key(cand)
+                if key not in scored and key not in seen:
+                    seen.add(key)
+                    candidates.append(cand)
+            if not candidates:
+                print("generation %d: no new candidates, stopping" % generation)
+                break
+            futures = {}
+            for cand in candidates:
+                futures[pool.submit(evaluate, args, hl_path, cand, costs, index)] = cand
+                index += 1
+            for future in concurrent.futures.as_completed(futures):
+                cand = futures[future]
+                score = future.result()
+                scored[pipeline_key(cand)] = (score, cand)
+            ranked = sorted((s for s in scored.values() if s[0] is not None),
+                            key=lambda s: s[0])
+            population = [p for _, p in ranked[:args.keep]]
+            print("generation %d: best %s = %d" % (generation, args.objective, ranked[0][0]))
+
+    ranked = sorted((s for s in scored.values() if s[0] is not None), key=lambda s: s[0])
+    for score, pipeline in ranked:
+        if not args.validate or validate(args, pipeline):
+            return base_score, score, pipeline
+        print("candidate with %s = %d failed validation, trying next" % (args.objective, score))
+    return base_score, base_score, base
+
+def main():
+    parser = argparse.ArgumentParser(description="Search for a per-shader optimization pipeline.")
+    parser.add_argument("shader", help="HLSL source file")
+    parser.add_argument("-E", dest="entry", default="main", help="entry point")
+    parser.add_argument("-T", dest="target", required=True, help="target profile")
+    parser.add_argument("-o", dest="output", required=True, help="pass file to write")
+    parser.add_argument("--objective", choices=["inst-count", "pressure", "cycles"],
+                        default="inst-count")
+    parser.add_argument("--cost-table", help="JSON opcode cost table for 'cycles'")
+    parser.add_argument("--generations", type=int, default=10)
+    parser.add_argument("--population", type=int, default=32,
+                        help="candidates evaluated per generation")
+    parser.add_argument("--keep", type=int, default=4,
+                        help="best pipelines mutated in the next generation")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--no-validate", dest="validate", action="store_false",
+                        help="skip validating the winning pipeline with dxa/dxv")
+    parser.add_argument("--dxc", default="dxc")
+    parser.add_argument("--dxopt", default="dxopt")
+    parser.add_argument("--dxa", default="dxa")
+    parser.add_argument("--dxv", default="dxv")
+    parser.add_argument("dxc_args", nargs=argparse.REMAINDER,
+                        help="extra dxc arguments, e.g. -- -HV 2018")
+    args = parser.parse_args()
+    if args.dxc_args and args.dxc_args[0] == "--":
+        args.dxc_args = args.dxc_args[1:]
+
+    args.workdir = tempfile.mkdtemp(prefix="hctopttune")
+    try:
+        base_score, score, pipeline = search(args)
+    finally:
+        shutil.rmtree(args.workdir, ignore_errors=True)
+
+    with open(args.output, "w") as f:
+        f.write("# Tuned by hctopttune.py for %s (-E %s -T %s)\n" %
+                (os.path.basename(args.shader), args.entry, args.target))
+        f.write("# %s: %d -> %d\n" % (args.objective, base_score, score))
+        f.write(pipeline_key(pipeline) + "\n")
+    print("%s: %d -> %d, written to %s" % (args.objective, base_score, score, args.output))
+    return 0
+
+if __name__ == "__main__":
+    if sys.argv[1:] == ["--self-test"]:
+        sys.exit(self_test())
+    sys.exit(main())